@@ -0,0 +1,69 @@
+from lpython import i32, i64, f64, Const
+
+# Helpers whose calls with compile time arguments are evaluated at compile
+# time with --fast, they must give the same results as at run time
+
+def mask(bits: i32) -> i64:
+    m: i64 = i64(0)
+    i: i32
+    for i in range(bits):
+        m = m | (i64(1) << i64(i))
+    return m
+
+def fib(n: i32) -> i32:
+    if n < 2:
+        return n
+    return fib(n - 1) + fib(n - 2)
+
+def gcd(a: i32, b: i32) -> i32:
+    t: i32
+    while b != 0:
+        t = b
+        b = a % b
+        a = t
+    return a
+
+def first_prime_after(n: i32) -> i32:
+    p: i32 = n + 1
+    d: i32
+    while True:
+        d = 2
+        while d * d <= p:
+            if p % d == 0:
+                break
+            d += 1
+        else:
+            return p
+        p += 1
+
+def poly(x: f64) -> f64:
+    return 3.0 * x * x - 2.0 * x + 0.5
+
+def is_odd(n: i32) -> bool:
+    return n % 2 == 1 and not (n // 2 < 0)
+
+def spin(n: i32) -> i32:
+    # Too long for the compile time evaluation, computed at run time
+    s: i32 = 0
+    i: i32
+    for i in range(n):
+        s = (s + i) % 1000
+    return s
+
+BITS: Const[i32] = 12
+LOW_BITS: i64 = mask(BITS)
+
+def test_comptime_eval():
+    assert LOW_BITS == i64(4095)
+    assert mask(3) == i64(7)
+    assert fib(15) == 610
+    assert gcd(84, 36) == 12
+    assert first_prime_after(89) == 97
+    assert abs(poly(2.0) - 8.5) < 1e-12
+    assert is_odd(7)
+    assert not is_odd(10)
+    assert spin(1000000) == 0
+    n: i32 = 20
+    assert fib(n) == 6765
+
+test_comptime_eval()
@@ -0,0 +1,24 @@
+from lpython import f64, i32
+from numpy import empty, float64
+
+def scale(a: f64[9216], s: f64):
+    i: i32
+    for i in range(9216):
+        a[i] = s * a[i]
+
+def total(a: f64[9216]) -> f64:
+    i: i32
+    r: f64 = 0.0
+    for i in range(9216):
+        r += a[i]
+    return r
+
+def main():
+    a: f64[9216] = empty(9216, dtype=float64)
+    i: i32
+    for i in range(9216):
+        a[i] = 1.0
+    scale(a, 2.0)
+    assert total(a) == 18432.0
+
+main()
@@ -0,0 +1,300 @@
+#!/usr/bin/env python
+
+"""
+Runtime performance of the backends on compute heavy integration tests.
+
+Every kernel (an integration test) is built with each backend that
+`CMakeLists.txt` lists for it (its `LABELS`), the compile time and the
+execution time are measured separately over several repetitions and the
+medians are shown in a table, one row per kernel and one column per backend.
+The `llvm_jit` backend compiles and runs in one process, its time is reported
+as execution time.
+
+The results can be stored (`--save-baseline`) and later runs compared to them
+(`--baseline`): a time that grows by more than `--threshold` (relative) and
+`--min-diff` (absolute, to ignore the noise of very short times) is reported
+as a regression and the script fails (exit code 1).
+
+Usage:
+
+    ./run_benchmarks.py -b llvm c wasm --save-baseline baseline.json
+    ./run_benchmarks.py -b llvm c wasm --baseline baseline.json
+"""
+
+import argparse
+import json
+import os
+import re
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+BASE_DIR = os.path.dirname(os.path.realpath(__file__))
+LPYTHON_PATH = f"{BASE_DIR}/../src/bin"
+
+SUPPORTED_BACKENDS = ['llvm', 'llvm_jit', 'c', 'wasm', 'wasm_x64', 'cpython']
+# Integration tests that spend most of their time computing (loops over
+# arrays, lists and dictionaries) rather than printing
+DEFAULT_KERNELS = ['elemental_02', 'expr_06', 'loop_02', 'loop_03',
+    'test_dict_01', 'test_dict_02', 'test_list_01', 'test_numpy_03', 'vec_01']
+
+RUN_OPTIONS = ['FAIL', 'NOFAST', 'NOMOD']
+RUN_ONE_VALUE_ARGS = ['NAME', 'IMPORT_PATH', 'COPY_TO_BIN', 'REQ_PY_VER']
+RUN_MULTI_VALUE_ARGS = ['LABELS', 'EXTRAFILES', 'EXTRA_ARGS']
+
+
+def read_run_entries():
+    """
+    The arguments of the `RUN(...)` entries of `CMakeLists.txt`, by name.
+    """
+    entries = {}
+    with open(os.path.join(BASE_DIR, "CMakeLists.txt")) as f:
+        text = f.read()
+    for m in re.finditer(r"^RUN\(([^)]*)\)", text, re.MULTILINE):
+        entry = {"LABELS": [], "EXTRAFILES": [], "EXTRA_ARGS": []}
+        key = None
+        for token in m.group(1).split():
+            if token in RUN_OPTIONS:
+                entry[token] = True
+                key = None
+            elif token in RUN_ONE_VALUE_ARGS or token in RUN_MULTI_VALUE_ARGS:
+                key = token
+            elif key in RUN_ONE_VALUE_ARGS:
+                entry[key] = token
+                key = None
+            elif key in RUN_MULTI_VALUE_ARGS:
+                entry[key].append(token)
+        if "NAME" in entry:
+            entries[entry["NAME"]] = entry
+    return entries
+
+
+def timed(cmd, cwd, env=None):
+    """
+    Runs `cmd`, returns its wall time in seconds. The output is discarded,
+    it is shown only if the command fails.
+    """
+    t1 = time.perf_counter()
+    p = subprocess.run(cmd, cwd=cwd, env=env, stdout=subprocess.PIPE,
+                       stderr=subprocess.STDOUT, universal_newlines=True)
+    t2 = time.perf_counter()
+    if p.returncode != 0:
+        raise RuntimeError(f"Command failed: {' '.join(cmd)}\n{p.stdout}")
+    return t2 - t1
+
+
+def commands(backend, lpython, filename, exe, extra_args):
+    """
+    The command that builds `filename` (None if there is nothing to build)
+    and the one that runs it.
+    """
+    if backend == "llvm":
+        return ([lpython] + extra_args + [filename, "-o", exe], [exe])
+    elif backend == "llvm_jit":
+        return (None, [lpython, "--jit"] + extra_args + [filename])
+    elif backend == "c":
+        return ([lpython, "--backend", "c"] + extra_args + [filename, "-o", exe],
+                [exe])
+    elif backend == "wasm":
+        return ([lpython, "--backend", "wasm"] + extra_args
+                + [filename, "-o", exe],
+                ["node", "--experimental-wasi-unstable-preview1", exe + ".js"])
+    elif backend == "wasm_x64":
+        return ([lpython, "--backend", "wasm_x64"] + extra_args
+                + [filename, "-o", exe], [exe])
+    elif backend == "cpython":
+        return (None, [sys.executable, filename])
+    raise ValueError(f"Unsupported backend: {backend}")
+
+
+def missing_tool(backend):
+    if backend == "wasm" and shutil.which("node") is None:
+        return "node"
+    return None
+
+
+def benchmark(kernel, entry, backend, lpython, args, tmp):
+    extra_args = list(entry["EXTRA_ARGS"])
+    if "IMPORT_PATH" in entry:
+        extra_args.append(f"-I{BASE_DIR}/{entry['IMPORT_PATH']}")
+    if args.fast and backend != "cpython" and not entry.get("NOFAST"):
+        extra_args.append("--fast")
+    filename = os.path.join(BASE_DIR, kernel + ".py")
+    exe = os.path.join(tmp, f"{kernel}_{backend}")
+    build, run = commands(backend, lpython, filename, exe, extra_args)
+    env = None
+    if backend == "cpython":
+        env = dict(os.environ)
+        env["PYTHONPATH"] = os.pathsep.join(
+            [f"{BASE_DIR}/../src/runtime/lpython", f"{BASE_DIR}/.."])
+
+    compile_times = []
+    run_times = []
+    for _ in range(args.repeat):
+        if build:
+            compile_times.append(timed(build, tmp))
+        run_times.append(timed(run, tmp, env))
+    return {
+        "compile": statistics.median(compile_times) if build else None,
+        "run": statistics.median(run_times),
+        "compile_samples": compile_times,
+        "run_samples": run_times,
+    }
+
+
+def format_time(t):
+    if t is None:
+        return "-"
+    return f"{t * 1000:.1f}"
+
+
+def print_table(results, backends):
+    print()
+    print("Median times in ms (compile / run)")
+    width = 20
+    print(f"{'kernel':<16}" + "".join(f"{b:>{width}}" for b in backends)
+          + f"{'fastest run':>{width}}")
+    for kernel, by_backend in results.items():
+        row = f"{kernel:<16}"
+        for backend in backends:
+            r = by_backend.get(backend)
+            if r is None:
+                cell = "n/a"
+            elif "error" in r:
+                cell = "failed"
+            else:
+                cell = f"{format_time(r['compile'])} / {format_time(r['run'])}"
+            row += f"{cell:>{width}}"
+        measured = {b: r["run"] for b, r in by_backend.items()
+                    if "error" not in r}
+        fastest = min(measured, key=measured.get) if measured else "-"
+        print(row + f"{fastest:>{width}}")
+
+
+def compare(results, baseline, threshold, min_diff):
+    """
+    The regressions of `results` with respect to `baseline`.
+    """
+    regressions = []
+    for kernel, by_backend in results.items():
+        for backend, r in by_backend.items():
+            old = baseline.get(kernel, {}).get(backend)
+            if old is None or "error" in r or "error" in old:
+                continue
+            for what in ["compile", "run"]:
+                t, t0 = r[what], old[what]
+                if t is None or t0 is None:
+                    continue
+                if t > t0 * (1 + threshold) and t - t0 > min_diff:
+                    regressions.append(f"{kernel} ({backend}): {what} "
+                        f"{format_time(t0)} -> {format_time(t)} ms "
+                        f"(+{(t / t0 - 1) * 100:.0f}%)")
+    return regressions
+
+
+def get_args():
+    parser = argparse.ArgumentParser(description="LPython Backend Benchmarks")
+    parser.add_argument("-b", "--backends", nargs="*", default=SUPPORTED_BACKENDS,
+                type=str, help="Benchmark the requested backends (%s), default: all" % \
+                        ", ".join(SUPPORTED_BACKENDS))
+    parser.add_argument("-k", "--kernels", nargs="*", default=DEFAULT_KERNELS,
+                type=str, help="The integration tests to benchmark, default: %s" % \
+                        ", ".join(DEFAULT_KERNELS))
+    parser.add_argument("-r", "--repeat", type=int, default=5,
+                help="Number of compilations and runs of each kernel, default: 5")
+    parser.add_argument("-f", "--fast", action='store_true',
+                help="Compile with --fast")
+    parser.add_argument("-o", "--output", default="benchmarks.json",
+                help="Where to write the results (JSON), default: benchmarks.json")
+    parser.add_argument("--baseline",
+                help="Compare the results to this file (written by --save-baseline)")
+    parser.add_argument("--save-baseline",
+                help="Also write the results to this file, to compare later runs to")
+    parser.add_argument("--threshold", type=float, default=0.1,
+                help="Relative slowdown reported as a regression, default: 0.1")
+    parser.add_argument("--min-diff", type=float, default=5,
+                help="Ignore slowdowns smaller than this (ms), default: 5")
+    return parser.parse_args()
+
+
+def main():
+    args = get_args()
+    os.environ["PATH"] = LPYTHON_PATH + os.pathsep + os.environ["PATH"]
+    lpython = shutil.which("lpython")
+    if lpython is None:
+        print("lpython not found")
+        return 1
+    args.repeat = max(args.repeat, 1)
+
+    for backend in args.backends:
+        if backend not in SUPPORTED_BACKENDS:
+            print(f"Unsupported Backend: {backend}")
+            return 1
+    backends = []
+    for backend in args.backends:
+        tool = missing_tool(backend)
+        if tool:
+            print(f"Skipping the {backend} backend: {tool} not found")
+        else:
+            backends.append(backend)
+
+    entries = read_run_entries()
+    results = {}
+    with tempfile.TemporaryDirectory() as tmp:
+        for kernel in args.kernels:
+            entry = entries.get(kernel)
+            if entry is None:
+                print(f"{kernel}: not an integration test")
+                return 1
+            if entry.get("FAIL") or entry["EXTRAFILES"]:
+                print(f"{kernel}: skipped (expected to fail or needs extra files)")
+                continue
+            if "COPY_TO_BIN" in entry:
+                shutil.copy(os.path.join(BASE_DIR, entry["COPY_TO_BIN"]), tmp)
+            results[kernel] = {}
+            for backend in backends:
+                if backend not in entry["LABELS"]:
+                    continue
+                print(f"+ {kernel} ({backend})")
+                try:
+                    results[kernel][backend] = benchmark(kernel, entry, backend,
+                        lpython, args, tmp)
+                except RuntimeError as e:
+                    print(e)
+                    results[kernel][backend] = {"error": str(e)}
+
+    print_table(results, backends)
+    data = {"lpython": lpython, "fast": args.fast, "repeat": args.repeat,
+            "results": results}
+    with open(args.output, "w") as f:
+        json.dump(data, f, indent=4)
+    print(f"Results written to {args.output}")
+    if args.save_baseline:
+        with open(args.save_baseline, "w") as f:
+            json.dump(data, f, indent=4)
+        print(f"Baseline written to {args.save_baseline}")
+
+    failed = any("error" in r for by_backend in results.values()
+                 for r in by_backend.values())
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        if baseline.get("fast") != args.fast:
+            print("Warning: the baseline was measured with a different --fast")
+        regressions = compare(results, baseline["results"], args.threshold,
+                              args.min_diff / 1000)
+        if regressions:
+            print(f"Regressions (more than {args.threshold * 100:.0f}% slower):")
+            for regression in regressions:
+                print("    " + regression)
+            failed = True
+        else:
+            print("No regressions")
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,34 @@
+from lpython import i32, i64, f64
+
+# Integer literals and literal expressions with intermediate results that do
+# not fit into 32 or 64 bits are evaluated exactly at compile time
+
+def test_large_int_literals():
+    a: i64 = i64(0x7FFFFFFFFFFFFFFF)
+    b: i64 = i64(-9223372036854775808)
+    c: i64 = i64((2**100 + 7) % 1000000007)
+    d: i64 = i64((0xcbf29ce484222325 * 0x100000001b3) % 2**61)
+    e: i64 = i64(2**70 // 2**8)
+    f: i64 = i64(0b1_0000000000_0000000000_0000000000_0000000000_0000000000_0000000000_00 >> 3)
+    g: i64 = i64(-(10**30) // 10**12)
+    print(a, b, c, d, e, f, g)
+    # Only used as floats
+    h: f64 = 1/2**70
+    k: f64 = 2**64 * 0.5
+    # i64 if the result does not fit into i32
+    m: i64 = 2**31 * 2
+    n: i32 = 2**31 - 1
+    print(h, k, m, n)
+    assert a == i64(9223372036854775807)
+    assert b + i64(1) == -i64(9223372036854775807)
+    assert c == i64(976371292)
+    assert d == i64(1108938069626697695)
+    assert e == i64(4611686018427387904)
+    assert f == i64(576460752303423488)
+    assert g == -i64(1000000000000000000)
+    assert h == 8.470329472543003e-22
+    assert k == 9223372036854775808.0
+    assert m == i64(4294967296)
+    assert n == 2147483647
+
+test_large_int_literals()
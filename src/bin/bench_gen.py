@@ -1,11 +1,13 @@
 #!/usr/bin/env python
 
-N = 10000
+import sys
 
-A_functions = ""
-calls = ""
-for i in range(N):
-    func_A = f"""
+
+def generate(N):
+    A_functions = ""
+    calls = ""
+    for i in range(N):
+        func_A = f"""
 def A{i}(x: i32) -> i32:
     y: i32
     z: i32
@@ -14,10 +16,10 @@ def A{i}(x: i32) -> i32:
     x = x + y * z
     return x
 """
-    A_functions += func_A
-    calls += f"    y = A{i}(y)\n"
+        A_functions += func_A
+        calls += f"    y = A{i}(y)\n"
 
-source = f"""\
+    source = f"""\
 from lpython import i32
 
 {A_functions}
@@ -33,5 +35,9 @@ def Main0():
 
 Main0()
 """
+    return source
+
 
-print(source)
+if __name__ == "__main__":
+    N = int(sys.argv[1]) if len(sys.argv) > 1 else 10000
+    print(generate(N))
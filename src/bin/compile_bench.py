@@ -0,0 +1,252 @@
+#!/usr/bin/env python
+
+"""
+Compiler throughput benchmark.
+
+Generates inputs of increasing size, compiles each of them with
+`lpython -c --time-report=json` and reports, for every stage of the
+compiler, its time and throughput in input tokens per second, plus the peak
+RSS of the compiler. The results are written as JSON.
+
+The script fails (exit code 1) if the time of a stage grows super-linearly
+with the size of the input, i.e., if between the two largest inputs of a
+kind its time grows faster than `tokens ** max_exponent`. Stages that take
+less than `min_time` ms on the largest input are not checked, they are
+dominated by the constant costs (loading the runtime library, ...).
+
+Usage:
+
+    compile_bench.py --lpython build/src/bin/lpython -o results.json
+"""
+
+import argparse
+import json
+import math
+import os
+import subprocess
+import sys
+import tempfile
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+
+import bench_gen
+
+
+def gen_functions(n):
+    # `n` functions and a driver calling all of them
+    return bench_gen.generate(n)
+
+
+def gen_nesting(n):
+    # `n` nested blocks, each indented by one more space (the indentation
+    # is only a small part of the source even for the deepest nesting)
+    lines = ["from lpython import i32", "", "def f(x: i32) -> i32:",
+             " y: i32 = 0"]
+    for i in range(n):
+        indent = " " * (i + 1)
+        if i % 2 == 0:
+            lines.append(f"{indent}if x > {i}:")
+        else:
+            lines.append(f"{indent}while y < {i}:")
+        lines.append(f"{indent} y = y + {i}")
+    lines.append(" return y")
+    lines += ["", "print(f(5))", ""]
+    return "\n".join(lines)
+
+
+def gen_expression(n):
+    # One expression with `n` terms
+    terms = " + ".join(f"x * {i}" for i in range(n))
+    return f"""\
+from lpython import i64
+
+def f(x: i64) -> i64:
+    return {terms}
+
+print(f(i64(5)))
+"""
+
+
+def gen_literal(n):
+    # A list literal with `n` elements and a string literal of `10 n`
+    # characters
+    elements = ", ".join(str(i) for i in range(n))
+    text = "abcdefghij" * n
+    return f"""\
+from lpython import i32
+
+def f() -> i32:
+    x: list[i32] = [{elements}]
+    s: str = "{text}"
+    return len(x) + len(s)
+
+print(f())
+"""
+
+
+def gen_overloads(n):
+    # `n` statements calling overloaded functions, the `@overload`ed `scale`
+    # and `abs`, `pow` of lpython_builtin, with a few argument types (the
+    # overload resolution dominates the "AST to ASR" stage)
+    lines = ["from lpython import i32, i64, f32, f64, overload", "",
+             "@overload", "def scale(x: i32) -> i32:", "    return 2 * x", "",
+             "@overload", "def scale(x: i64) -> i64:", "    return i64(2) * x", "",
+             "@overload", "def scale(x: f32) -> f32:", "    return f32(2) * x", "",
+             "@overload", "def scale(x: f64) -> f64:", "    return 2.0 * x", "",
+             "def f() -> f64:",
+             "    a: i32 = -3", "    b: i64 = i64(-4)",
+             "    c: f32 = f32(-1.5)", "    d: f64 = -2.5",
+             "    s: f64 = 0.0"]
+    calls = ["s += f64(scale(abs(a)))", "s += f64(scale(abs(b)))",
+             "s += f64(scale(abs(c)))", "s += scale(abs(d))",
+             "s += pow(d, 2.0)", "s += pow(a, a)"]
+    for i in range(n):
+        lines.append("    " + calls[i % len(calls)])
+    lines += ["    return s", "", "print(f())", ""]
+    return "\n".join(lines)
+
+
+GENERATORS = {
+    "functions": (gen_functions, [1000, 10000, 100000]),
+    "nesting": (gen_nesting, [100, 200, 400]),
+    "expression": (gen_expression, [1000, 2000, 4000]),
+    "literal": (gen_literal, [1000, 10000, 100000]),
+    "overloads": (gen_overloads, [1000, 4000, 16000]),
+}
+
+
+def count_tokens(lpython, filename):
+    r = subprocess.run([lpython, "--show-tokens", "--no-color", filename],
+                       stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                       universal_newlines=True)
+    if r.returncode != 0:
+        return None
+    return sum(1 for line in r.stdout.splitlines() if line.strip())
+
+
+def compile_file(lpython, filename, extra_args):
+    """
+    Returns the time report and the peak RSS in bytes (None if unknown).
+    """
+    args = [lpython, "-c", filename, "-o", filename + ".o",
+            "--time-report=json"] + extra_args
+    with tempfile.TemporaryFile(mode="w+") as stderr:
+        p = subprocess.Popen(args, stdout=subprocess.PIPE, stderr=stderr,
+                             universal_newlines=True)
+        stdout = p.stdout.read()
+        p.stdout.close()
+        peak_rss = None
+        if hasattr(os, "wait4"):
+            # The resource usage of this child only (on Linux the peak RSS
+            # is at least that of this script, from before the `exec`)
+            _, status, rusage = os.wait4(p.pid, 0)
+            p.returncode = (os.WEXITSTATUS(status) if os.WIFEXITED(status)
+                            else -1)
+            # kB on Linux, bytes on macOS
+            peak_rss = rusage.ru_maxrss
+            if sys.platform != "darwin":
+                peak_rss *= 1024
+        else:
+            p.wait()
+        if p.returncode != 0:
+            stderr.seek(0)
+            sys.stderr.write(stderr.read())
+            raise RuntimeError(f"lpython failed on {filename}")
+    report = None
+    for line in stdout.splitlines():
+        if line.startswith("{"):
+            report = json.loads(line)
+    if report is None:
+        raise RuntimeError(f"no time report for {filename}")
+    return report, peak_rss
+
+
+def scaling_exponent(small, large, stage):
+    t1 = small["stages"].get(stage)
+    t2 = large["stages"].get(stage)
+    if t1 is None or t2 is None or t1 <= 0 or t2 <= 0:
+        return None
+    return math.log(t2 / t1) / math.log(large["tokens"] / small["tokens"])
+
+
+def main():
+    parser = argparse.ArgumentParser(description="LPython compiler throughput benchmark")
+    parser.add_argument("--lpython", default="lpython",
+                        help="the lpython executable")
+    parser.add_argument("-o", "--output", default="compile_bench.json",
+                        help="where to write the results (JSON)")
+    parser.add_argument("-k", "--kind", action="append",
+                        choices=sorted(GENERATORS),
+                        help="only run these kinds of inputs")
+    parser.add_argument("--quick", action="store_true",
+                        help="skip the largest input of each kind")
+    parser.add_argument("--max-exponent", type=float, default=1.3,
+                        help="fail if a stage scales worse than tokens**max_exponent")
+    parser.add_argument("--min-time", type=float, default=50,
+                        help="do not check stages faster than this (ms)")
+    parser.add_argument("--fast", action="store_true",
+                        help="compile with --fast")
+    args = parser.parse_args()
+
+    extra_args = ["--fast"] if args.fast else []
+    kinds = args.kind or sorted(GENERATORS)
+    results = {"lpython": args.lpython, "args": extra_args, "kinds": {}}
+    failures = []
+    with tempfile.TemporaryDirectory() as tmp:
+        for kind in kinds:
+            generate, sizes = GENERATORS[kind]
+            if args.quick:
+                sizes = sizes[:-1]
+            runs = []
+            for n in sizes:
+                filename = os.path.join(tmp, f"{kind}_{n}.py")
+                with open(filename, "w") as f:
+                    f.write(generate(n))
+                tokens = count_tokens(args.lpython, filename)
+                if tokens is None:
+                    raise RuntimeError(f"tokenizing {filename} failed")
+                report, peak_rss = compile_file(args.lpython, filename,
+                                                extra_args)
+                stages = {s["name"]: s["time_ms"] for s in report["stages"]}
+                run = {
+                    "size": n,
+                    "bytes": os.path.getsize(filename),
+                    "tokens": tokens,
+                    "stages": stages,
+                    "tokens_per_s": {name: tokens / (t / 1000)
+                                     for name, t in stages.items() if t > 0},
+                    "peak_rss": peak_rss,
+                }
+                runs.append(run)
+                print(f"{kind} {n}: {tokens} tokens, "
+                      + ", ".join(f"{name} {t:.1f}ms" for name, t in stages.items())
+                      + (f", peak RSS {run['peak_rss'] // (1024*1024)} MB"
+                         if run["peak_rss"] else ""))
+
+            scaling = {}
+            if len(runs) >= 2:
+                small, large = runs[-2], runs[-1]
+                for stage, t in large["stages"].items():
+                    e = scaling_exponent(small, large, stage)
+                    if e is None:
+                        continue
+                    scaling[stage] = e
+                    if t >= args.min_time and e > args.max_exponent:
+                        failures.append(f"{kind}: '{stage}' scales as "
+                                        f"tokens**{e:.2f} ({small['size']} -> "
+                                        f"{large['size']})")
+            results["kinds"][kind] = {"runs": runs, "scaling": scaling}
+
+    with open(args.output, "w") as f:
+        json.dump(results, f, indent=4)
+    print(f"Results written to {args.output}")
+    if failures:
+        print("Super-linear scaling:")
+        for failure in failures:
+            print("    " + failure)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
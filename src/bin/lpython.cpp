@@ -1,7 +1,15 @@
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdio>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
 #include <stdlib.h>
 #include <cstdlib>
+#include <thread>
 
 #define CLI11_HAS_FILESYSTEM 0
 #include <bin/CLI11.hpp>
@@ -32,6 +40,15 @@
 #include <lpython/python_kernel.h>
 #include <lpython/utils.h>
 #include <lpython/python_serialization.h>
+#include <lpython/asr_cache.h>
+#include <lpython/ast_cache.h>
+#include <lpython/time_report.h>
+#include <lpython/lld_link.h>
+#ifdef HAVE_LFORTRAN_LLVM
+#include <lpython/incremental.h>
+#include <lpython/jit_cache.h>
+#include <lpython/opt_remarks.h>
+#endif
 #include <lpython/parser/tokenizer.h>
 #include <lpython/parser/parser.h>
 #include <libasr/exception.h>
@@ -84,6 +101,78 @@ std::string get_kokkos_dir()
     throw LCompilers::LCompilersException("LFORTRAN_KOKKOS_DIR is not defined");
 }
 
+// `--time-report=json`
+bool time_report_json = false;
+
+// `--mem-report`
+bool mem_report = false;
+
+// `--parse-jobs`
+size_t parse_jobs = 1;
+
+// `--no-runtime-lto`
+bool runtime_lto = true;
+
+// `--jit-cache-dir` (or LPYTHON_JIT_CACHE_DIR)
+std::string jit_cache_dir;
+
+// `--profile-generate`, `--profile-use`
+bool profile_generate = false;
+std::string profile_use;
+
+// `--multiversion=avx2,avx512`
+std::vector<std::string> multiversion;
+
+// `--opt-remarks`, `--opt-remarks=json`
+bool opt_remarks = false;
+bool opt_remarks_json = false;
+
+void print_time_report(const LCompilers::LPython::CompilationReport &report, bool time_report) {
+    // Several files can be compiled at once (see `-j`), keep each report
+    // in one piece
+    static std::mutex print_mutex;
+    std::lock_guard<std::mutex> lock(print_mutex);
+    if (time_report) {
+        if (time_report_json) {
+            std::cout << LCompilers::LPython::time_report_to_json(report) << std::endl;
+        } else {
+            std::cout << LCompilers::LPython::time_report_to_text(report);
+        }
+    }
+    if (mem_report) {
+        // As on the paths that print what they emit (see EmitMemReport)
+        std::cerr << LCompilers::LPython::mem_report_to_text(report);
+    }
+}
+
+/*
+    `--mem-report` for the paths that print what they emit (`--show-*`):
+    the memory after each stage, printed to stderr when the path returns
+*/
+class EmitMemReport {
+public:
+    EmitMemReport(const std::string &infile, Allocator &al) : al{al} {
+        report.filename = infile;
+    }
+
+    ~EmitMemReport() {
+        if (mem_report) {
+            std::cerr << LCompilers::LPython::mem_report_to_text(report);
+        }
+    }
+
+    void stage(const std::string &name) {
+        if (mem_report) {
+            report.memory.push_back(LCompilers::LPython::get_memory_usage(name, al));
+        }
+    }
+
+    LCompilers::LPython::CompilationReport report;
+
+private:
+    Allocator &al;
+};
+
 #ifdef HAVE_LFORTRAN_LLVM
 
 #endif
@@ -93,11 +182,13 @@ int emit_tokens(const std::string &infile, bool line_numbers, const CompilerOpti
     std::string input = LCompilers::read_file_ok(infile);
     // Src -> Tokens
     Allocator al(64*1024*1024);
+    EmitMemReport mem(infile, al);
     std::vector<int> toks;
     std::vector<LCompilers::LPython::YYSTYPE> stypes;
     std::vector<LCompilers::Location> locations;
     LCompilers::diag::Diagnostics diagnostics;
     auto res = LCompilers::LPython::tokens(al, input, diagnostics, &stypes, &locations);
+    mem.stage("Tokenizing");
     LCompilers::LocationManager lm;
     {
         LCompilers::LocationManager::FileLocations fl;
@@ -131,9 +222,11 @@ int emit_ast(const std::string &infile,
     CompilerOptions &compiler_options)
 {
     Allocator al(4*1024);
+    EmitMemReport mem(infile, al);
     LCompilers::diag::Diagnostics diagnostics;
     LCompilers::Result<LCompilers::LPython::AST::ast_t*> r = parse_python_file(
         al, runtime_library_dir, infile, diagnostics, 0, compiler_options.new_parser);
+    mem.stage("Parsing");
     if (diagnostics.diagnostics.size() > 0) {
         LCompilers::LocationManager lm;
         {
@@ -191,6 +284,7 @@ int emit_asr(const std::string &infile,
     bool with_intrinsic_modules, CompilerOptions &compiler_options)
 {
     Allocator al(4*1024);
+    EmitMemReport mem(infile, al);
     LCompilers::diag::Diagnostics diagnostics;
     LCompilers::LocationManager lm;
     {
@@ -203,6 +297,7 @@ int emit_asr(const std::string &infile,
     }
     LCompilers::Result<LCompilers::LPython::AST::ast_t*> r1 = parse_python_file(
         al, runtime_library_dir, infile, diagnostics, 0, compiler_options.new_parser);
+    mem.stage("Parsing");
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!r1.ok) {
         return 1;
@@ -213,6 +308,7 @@ int emit_asr(const std::string &infile,
     LCompilers::Result<LCompilers::ASR::TranslationUnit_t*>
         r = LCompilers::LPython::python_ast_to_asr(al, lm, nullptr, *ast, diagnostics,
             compiler_options, true, "__main__", infile);
+    mem.stage("AST to ASR");
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!r.ok) {
         LCOMPILERS_ASSERT(diagnostics.has_error())
@@ -223,6 +319,7 @@ int emit_asr(const std::string &infile,
     compiler_options.po.run_fun = "f";
 
     pass_manager.apply_passes(al, asr, compiler_options.po, diagnostics);
+    mem.stage("ASR passes");
 
     if (compiler_options.po.tree) {
         std::cout << LCompilers::pickle_tree(*asr,
@@ -244,6 +341,7 @@ int emit_cpp(const std::string &infile,
     CompilerOptions &compiler_options)
 {
     Allocator al(4*1024);
+    EmitMemReport mem(infile, al);
     LCompilers::diag::Diagnostics diagnostics;
     LCompilers::LocationManager lm;
     {
@@ -256,6 +354,7 @@ int emit_cpp(const std::string &infile,
     }
     LCompilers::Result<LCompilers::LPython::AST::ast_t*> r = parse_python_file(
         al, runtime_library_dir, infile, diagnostics, 0, compiler_options.new_parser);
+    mem.stage("Parsing");
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!r.ok) {
         return 1;
@@ -265,6 +364,7 @@ int emit_cpp(const std::string &infile,
     diagnostics.diagnostics.clear();
     LCompilers::Result<LCompilers::ASR::TranslationUnit_t*>
         r1 = LCompilers::LPython::python_ast_to_asr(al, lm, nullptr, *ast, diagnostics, compiler_options, true, "__main__", infile);
+    mem.stage("AST to ASR");
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!r1.ok) {
         LCOMPILERS_ASSERT(diagnostics.has_error())
@@ -274,6 +374,7 @@ int emit_cpp(const std::string &infile,
 
     diagnostics.diagnostics.clear();
     auto res = LCompilers::asr_to_cpp(al, *asr, diagnostics, compiler_options, 0);
+    mem.stage("ASR to C++");
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!res.ok) {
         LCOMPILERS_ASSERT(diagnostics.has_error())
@@ -289,6 +390,7 @@ int emit_c(const std::string &infile,
     CompilerOptions &compiler_options)
 {
     Allocator al(4*1024);
+    EmitMemReport mem(infile, al);
     LCompilers::diag::Diagnostics diagnostics;
     LCompilers::LocationManager lm;
     {
@@ -301,6 +403,7 @@ int emit_c(const std::string &infile,
     }
     LCompilers::Result<LCompilers::LPython::AST::ast_t*> r = parse_python_file(
         al, runtime_library_dir, infile, diagnostics, 0, compiler_options.new_parser);
+    mem.stage("Parsing");
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!r.ok) {
         return 1;
@@ -310,6 +413,7 @@ int emit_c(const std::string &infile,
     diagnostics.diagnostics.clear();
     LCompilers::Result<LCompilers::ASR::TranslationUnit_t*>
         r1 = LCompilers::LPython::python_ast_to_asr(al, lm, nullptr, *ast, diagnostics, compiler_options, true, "__main__", infile);
+    mem.stage("AST to ASR");
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!r1.ok) {
         LCOMPILERS_ASSERT(diagnostics.has_error())
@@ -324,9 +428,11 @@ int emit_c(const std::string &infile,
     compiler_options.po.c_skip_bindpy_pass = true;
 
     pass_manager.apply_passes(al, asr, compiler_options.po, diagnostics);
+    mem.stage("ASR passes");
 
     diagnostics.diagnostics.clear();
     auto res = LCompilers::asr_to_c(al, *asr, diagnostics, compiler_options, 0);
+    mem.stage("ASR to C");
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!res.ok) {
         LCOMPILERS_ASSERT(diagnostics.has_error())
@@ -341,6 +447,7 @@ int emit_c_to_file(const std::string &infile, const std::string &outfile,
     CompilerOptions &compiler_options)
 {
     Allocator al(4*1024);
+    EmitMemReport mem(infile, al);
     LCompilers::diag::Diagnostics diagnostics;
     LCompilers::LocationManager lm;
     {
@@ -353,6 +460,7 @@ int emit_c_to_file(const std::string &infile, const std::string &outfile,
     }
     LCompilers::Result<LCompilers::LPython::AST::ast_t*> r = parse_python_file(
         al, runtime_library_dir, infile, diagnostics, 0, compiler_options.new_parser);
+    mem.stage("Parsing");
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!r.ok) {
         return 1;
@@ -362,6 +470,7 @@ int emit_c_to_file(const std::string &infile, const std::string &outfile,
     diagnostics.diagnostics.clear();
     LCompilers::Result<LCompilers::ASR::TranslationUnit_t*>
         r1 = LCompilers::LPython::python_ast_to_asr(al, lm, nullptr, *ast, diagnostics, compiler_options, true, "__main__", infile);
+    mem.stage("AST to ASR");
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!r1.ok) {
         LCOMPILERS_ASSERT(diagnostics.has_error())
@@ -375,9 +484,11 @@ int emit_c_to_file(const std::string &infile, const std::string &outfile,
 
     pass_manager.use_default_passes(true);
     pass_manager.apply_passes(al, asr, compiler_options.po, diagnostics);
+    mem.stage("ASR passes");
 
     diagnostics.diagnostics.clear();
     auto res = LCompilers::asr_to_c(al, *asr, diagnostics, compiler_options, 0);
+    mem.stage("ASR to C");
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!res.ok) {
         LCOMPILERS_ASSERT(diagnostics.has_error())
@@ -395,6 +506,7 @@ int emit_python(const std::string &infile,
     CompilerOptions &compiler_options)
 {
     Allocator al(4*1024);
+    EmitMemReport mem(infile, al);
     LCompilers::diag::Diagnostics diagnostics;
     LCompilers::LocationManager lm;
     {
@@ -407,6 +519,7 @@ int emit_python(const std::string &infile,
     }
     LCompilers::Result<LCompilers::LPython::AST::ast_t*> r = parse_python_file(
         al, runtime_library_dir, infile, diagnostics, 0, compiler_options.new_parser);
+    mem.stage("Parsing");
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!r.ok) {
         return 1;
@@ -418,6 +531,7 @@ int emit_python(const std::string &infile,
     // AST -> ASR
     LCompilers::Result<LCompilers::ASR::TranslationUnit_t*>
         r1 = LCompilers::LPython::python_ast_to_asr(al, lm, nullptr, *ast, diagnostics, compiler_options, true, "__main__", infile);
+    mem.stage("AST to ASR");
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!r1.ok) {
         LCOMPILERS_ASSERT(diagnostics.has_error())
@@ -431,6 +545,7 @@ int emit_python(const std::string &infile,
     bool color = false;
     int indent = 0;
     LCompilers::Result<std::string> res = LCompilers::asr_to_python(al, *asr, diagnostics, compiler_options, color, indent);
+    mem.stage("ASR to Python");
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!res.ok) {
         LCOMPILERS_ASSERT(diagnostics.has_error())
@@ -445,6 +560,7 @@ int emit_wat(const std::string &infile,
     CompilerOptions &compiler_options)
 {
     Allocator al(4*1024);
+    EmitMemReport mem(infile, al);
     LCompilers::diag::Diagnostics diagnostics;
     LCompilers::LocationManager lm;
     {
@@ -457,6 +573,7 @@ int emit_wat(const std::string &infile,
     }
     LCompilers::Result<LCompilers::LPython::AST::ast_t*> r = parse_python_file(
         al, runtime_library_dir, infile, diagnostics, 0, compiler_options.new_parser);
+    mem.stage("Parsing");
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!r.ok) {
         return 1;
@@ -466,6 +583,7 @@ int emit_wat(const std::string &infile,
     diagnostics.diagnostics.clear();
     LCompilers::Result<LCompilers::ASR::TranslationUnit_t*>
         r1 = LCompilers::LPython::python_ast_to_asr(al, lm, nullptr, *ast, diagnostics, compiler_options, true, "__main__", infile);
+    mem.stage("AST to ASR");
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!r1.ok) {
         LCOMPILERS_ASSERT(diagnostics.has_error())
@@ -475,6 +593,7 @@ int emit_wat(const std::string &infile,
 
     diagnostics.diagnostics.clear();
     LCompilers::Result<LCompilers::Vec<uint8_t>> r2 = LCompilers::asr_to_wasm_bytes_stream(*asr, al, diagnostics, compiler_options);
+    mem.stage("ASR to WASM");
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!r2.ok) {
         LCOMPILERS_ASSERT(diagnostics.has_error())
@@ -483,6 +602,7 @@ int emit_wat(const std::string &infile,
 
     diagnostics.diagnostics.clear();
     LCompilers::Result<std::string> res = LCompilers::wasm_to_wat(r2.result, al, diagnostics);
+    mem.stage("WASM to WAT");
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!res.ok) {
         LCOMPILERS_ASSERT(diagnostics.has_error())
@@ -737,14 +857,6 @@ int get_errors (const std::string &infile,
 
 #endif
 
-void print_time_report(std::vector<std::pair<std::string, double>> &times, bool time_report) {
-    if (time_report) {
-        for (auto &stage :times) {
-            std::cout << stage.first << ": " << stage.second << "ms" << std::endl;
-        }
-    }
-}
-
 #ifdef HAVE_LFORTRAN_LLVM
 
 void section(const std::string &s)
@@ -758,6 +870,7 @@ int emit_llvm(const std::string &infile,
     CompilerOptions &compiler_options)
 {
     Allocator al(4*1024);
+    EmitMemReport mem(infile, al);
     LCompilers::diag::Diagnostics diagnostics;
     LCompilers::LocationManager lm;
     {
@@ -770,6 +883,7 @@ int emit_llvm(const std::string &infile,
     }
     LCompilers::Result<LCompilers::LPython::AST::ast_t*> r = parse_python_file(
         al, runtime_library_dir, infile, diagnostics, 0, compiler_options.new_parser);
+    mem.stage("Parsing");
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!r.ok) {
         return 1;
@@ -780,6 +894,7 @@ int emit_llvm(const std::string &infile,
     diagnostics.diagnostics.clear();
     LCompilers::Result<LCompilers::ASR::TranslationUnit_t*>
         r1 = LCompilers::LPython::python_ast_to_asr(al, lm, nullptr, *ast, diagnostics, compiler_options, true, "__main__", infile);
+    mem.stage("AST to ASR");
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!r1.ok) {
         LCOMPILERS_ASSERT(diagnostics.has_error())
@@ -790,6 +905,11 @@ int emit_llvm(const std::string &infile,
 
     // ASR -> LLVM
     LCompilers::PythonCompiler fe(compiler_options);
+    // Adds the memory after the ASR passes and LLVM IR generation (and the
+    // LLVM optimization with `--fast`)
+    if (mem_report) {
+        fe.report = &mem.report;
+    }
     LCompilers::Result<std::unique_ptr<LCompilers::LLVMModule>>
         res = fe.get_llvm3(*asr, pass_manager, diagnostics, lm, infile);
     std::cerr << diagnostics.render(lm, compiler_options);
@@ -1035,9 +1155,67 @@ int interactive_python_repl(
     return 0;
 }
 
+// The semantic analysis, the ASR passes and the LLVM IR generation share
+// global state (symbol table counters, intrinsic registries, the pass
+// manager, ...), so only one file at a time may go through them. Parsing,
+// the LLVM optimizations and the object code generation run concurrently.
+std::mutex frontend_mutex;
+
+/*
+    A Python file read and parsed by `parse_python_file`. The AST is
+    allocated in `al` (and in `parse_arenas` with `--parse-jobs`), which the
+    rest of the compilation of the file keeps using.
+*/
+struct ParsedPythonFile {
+    Allocator al{4*1024};
+    LCompilers::diag::Diagnostics diagnostics;
+    LCompilers::LocationManager lm;
+    // Shared by the LocationManager and the parser
+    LCompilers::LPython::SourceBuffer source;
+    std::vector<std::unique_ptr<Allocator>> parse_arenas;
+    bool read = false;
+    // nullptr if the file could not be read or parsed
+    LCompilers::LPython::AST::Module_t *ast = nullptr;
+    double reading_time = 0, parsing_time = 0;
+};
+
+void parse_python_file(const std::string &infile, ParsedPythonFile &file) {
+    LCompilers::LocationManager::FileLocations fl;
+    fl.in_filename = infile;
+    file.lm.files.push_back(fl);
+
+    auto file_reading_start = std::chrono::high_resolution_clock::now();
+    if (!file.source.load_file(infile)) {
+        return;
+    }
+    file.read = true;
+    auto file_reading_end = std::chrono::high_resolution_clock::now();
+    file.reading_time = std::chrono::duration<double, std::milli>(
+        file_reading_end - file_reading_start).count();
+
+    file.source.init_location_manager(file.lm);
+    file.lm.file_ends.push_back(file.source.size());
+
+    auto parsing_start = std::chrono::high_resolution_clock::now();
+    LCompilers::Result<LCompilers::LPython::AST::Module_t*> r
+        = LCompilers::LPython::parse_parallel(file.al, file.parse_arenas,
+            file.source, 0, file.diagnostics, parse_jobs);
+    auto parsing_end = std::chrono::high_resolution_clock::now();
+    file.parsing_time = std::chrono::duration<double, std::milli>(
+        parsing_end - parsing_start).count();
+    if (r.ok) {
+        file.ast = r.result;
+    }
+}
+
 /*
     Compiles python to object file, if `to_jit` is false
     otherwise execute python code using llvm JIT
+
+    `parsed` is the file already parsed by `parse_python_file`, if nullptr
+    the file is parsed here. If `pyc_dir` is given, the ASR of a module
+    compiled with `--disable-main` is written there instead of next to
+    `infile`.
 */
 int compile_python_using_llvm(
         const std::string &infile,
@@ -1045,56 +1223,97 @@ int compile_python_using_llvm(
         const std::string &runtime_library_dir,
         LCompilers::PassManager& pass_manager,
         CompilerOptions &compiler_options,
-        bool time_report, bool arg_c=false, bool to_jit=false)
+        bool time_report, bool arg_c=false, bool to_jit=false,
+        const std::string &module_name="__main__",
+        const std::string &incremental_dir="",
+        std::vector<std::string> *module_objects=nullptr,
+        ParsedPythonFile *parsed=nullptr,
+        const std::string &pyc_dir="")
 {
-    Allocator al(4*1024);
-    LCompilers::diag::Diagnostics diagnostics;
-    LCompilers::LocationManager lm;
-    std::vector<std::pair<std::string, double>>times;
-    {
-        LCompilers::LocationManager::FileLocations fl;
-        fl.in_filename = infile;
-        lm.files.push_back(fl);
-
-        auto file_reading_start = std::chrono::high_resolution_clock::now();
-        std::string input = LCompilers::read_file_ok(infile);
-        auto file_reading_end = std::chrono::high_resolution_clock::now();
-        times.push_back(std::make_pair("File reading", std::chrono::duration
-            <double, std::milli>(file_reading_end - file_reading_start).count()));
-
-        lm.init_simple(input);
-        lm.file_ends.push_back(input.size());
+    std::unique_ptr<ParsedPythonFile> own_parsed;
+    if (!parsed) {
+        own_parsed = std::make_unique<ParsedPythonFile>();
+        parsed = own_parsed.get();
+    }
+    Allocator &al = parsed->al;
+    LCompilers::diag::Diagnostics &diagnostics = parsed->diagnostics;
+    LCompilers::LocationManager &lm = parsed->lm;
+    LCompilers::LPython::CompilationReport report;
+    report.filename = infile;
+    std::vector<std::pair<std::string, double>> &times = report.times;
+    LCompilers::LPython::CodegenOptions codegen_options;
+    if (runtime_lto && compiler_options.target.empty()) {
+        // Only present if built with WITH_RUNTIME_BITCODE; the bitcode is
+        // compiled for the host, so it is not used when cross compiling
+        std::string runtime_bitcode = runtime_library_dir + "/lpython_runtime.bc";
+        if (LCompilers::LPython::path_exists(runtime_bitcode)) {
+            codegen_options.runtime_bitcode = runtime_bitcode;
+        }
+    }
+    // The profile is written at exit, which only executables do
+    codegen_options.profile_generate = profile_generate && !to_jit;
+    codegen_options.profile_use = profile_use;
+    // ifuncs are resolved by the dynamic loader, the JIT does not support them
+    if (!to_jit) codegen_options.multiversion = multiversion;
+    // Identifies the incremental builds and the JIT cache entries
+    uint64_t options_hash = 0;
+    if (!incremental_dir.empty() || (to_jit && !jit_cache_dir.empty())) {
+        options_hash = LCompilers::LPython::get_incremental_options_hash(
+            compiler_options, codegen_options);
+    }
+    if (!incremental_dir.empty() && !to_jit) {
+        // Nothing needs to be parsed if neither the program nor any module
+        // it imports changed since the previous build
+        auto check_start = std::chrono::high_resolution_clock::now();
+        bool up_to_date = LCompilers::LPython::is_incremental_build_up_to_date(
+            infile, outfile, incremental_dir, options_hash, *module_objects);
+        auto check_end = std::chrono::high_resolution_clock::now();
+        if (up_to_date) {
+            times.push_back(std::make_pair("Up to date check", std::chrono::duration
+                <double, std::milli>(check_end - check_start).count()));
+            print_time_report(report, time_report);
+            return 0;
+        }
     }
-    auto parsing_start = std::chrono::high_resolution_clock::now();
-    LCompilers::Result<LCompilers::LPython::AST::ast_t*> r = parse_python_file(
-        al, runtime_library_dir, infile, diagnostics, 0, compiler_options.new_parser);
-    auto parsing_end = std::chrono::high_resolution_clock::now();
-    times.push_back(std::make_pair("Parsing", std::chrono::duration<double, std::milli>(parsing_end - parsing_start).count()));
+    if (own_parsed) {
+        parse_python_file(infile, *parsed);
+    }
+    if (!parsed->read) {
+        std::cerr << "File '" << infile << "' cannot be opened." << std::endl;
+        return 1;
+    }
+    times.push_back(std::make_pair("File reading", parsed->reading_time));
+    times.push_back(std::make_pair("Parsing", parsed->parsing_time));
+    report.memory.push_back(LCompilers::LPython::get_memory_usage("Parsing", al));
+    std::unique_lock<std::mutex> frontend_lock(frontend_mutex);
     std::cerr << diagnostics.render(lm, compiler_options);
-    if (!r.ok) {
-        print_time_report(times, time_report);
+    if (!parsed->ast) {
+        print_time_report(report, time_report);
         return 1;
     }
 
     // Src -> AST -> ASR
-    LCompilers::LPython::AST::ast_t* ast = r.result;
+    LCompilers::LPython::AST::ast_t* ast = (LCompilers::LPython::AST::ast_t*)parsed->ast;
     diagnostics.diagnostics.clear();
     auto ast_to_asr_start = std::chrono::high_resolution_clock::now();
     LCompilers::Result<LCompilers::ASR::TranslationUnit_t*>
         r1 = LCompilers::LPython::python_ast_to_asr(al, lm, nullptr, *ast, diagnostics, compiler_options,
-            !(arg_c && compiler_options.po.disable_main), "__main__", infile);
+            !(arg_c && compiler_options.po.disable_main), module_name, infile);
 
     auto ast_to_asr_end = std::chrono::high_resolution_clock::now();
     times.push_back(std::make_pair("AST to ASR", std::chrono::duration<double, std::milli>(ast_to_asr_end - ast_to_asr_start).count()));
+    report.memory.push_back(LCompilers::LPython::get_memory_usage("AST to ASR", al));
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!r1.ok) {
         LCOMPILERS_ASSERT(diagnostics.has_error())
-        print_time_report(times, time_report);
+        print_time_report(report, time_report);
         return 2;
     }
     LCompilers::ASR::TranslationUnit_t* asr = r1.result;
     if( compiler_options.po.disable_main ) {
-        int err = LCompilers::LPython::save_pyc_files(*asr, infile, lm);
+        // `save_pyc_files` replaces the extension of the file name by `.pyc`
+        int err = LCompilers::LPython::save_pyc_files(*asr, pyc_dir.empty()
+            ? infile : pyc_dir + "/" + module_name + ".py", lm);
         if( err ) {
             return err;
         }
@@ -1116,16 +1335,44 @@ int compile_python_using_llvm(
     }
     LCompilers::PythonCompiler fe(compiler_options);
     LCompilers::LLVMEvaluator e(compiler_options.target);
+    if (time_report || mem_report) {
+        fe.report = &report;
+    }
+    LCompilers::LPython::OptRemarks remarks;
+    if (opt_remarks) {
+        fe.opt_remarks = &remarks;
+    }
+    fe.runtime_bitcode = codegen_options.runtime_bitcode;
+    fe.profile_generate = codegen_options.profile_generate;
+    fe.profile_use = codegen_options.profile_use;
+    fe.multiversion = codegen_options.multiversion;
     auto asr_to_llvm_start = std::chrono::high_resolution_clock::now();
     LCompilers::Result<std::unique_ptr<LCompilers::LLVMModule>>
-        res = fe.get_llvm3(*asr, pass_manager, diagnostics, lm, infile);
+        res_ir = fe.get_llvm_ir(*asr, pass_manager, diagnostics, lm, infile);
+    // The LLVM optimizations only work on this file's LLVM module, they run
+    // concurrently with the other files
+    frontend_lock.unlock();
+    LCompilers::Result<std::unique_ptr<LCompilers::LLVMModule>> res = res_ir.ok
+        ? fe.optimize_llvm(std::move(res_ir.result), *asr, diagnostics, lm, infile)
+        : LCompilers::Result<std::unique_ptr<LCompilers::LLVMModule>>(res_ir.error);
     auto asr_to_llvm_end = std::chrono::high_resolution_clock::now();
     times.push_back(std::make_pair("ASR to LLVM", std::chrono::duration<double, std::milli>(asr_to_llvm_end - asr_to_llvm_start).count()));
 
+    if (opt_remarks) {
+        if (opt_remarks_json) {
+            // Several files can be compiled at once (see `-j`)
+            static std::mutex print_mutex;
+            std::lock_guard<std::mutex> lock(print_mutex);
+            std::cout << LCompilers::LPython::opt_remarks_to_json(remarks, lm,
+                infile) << std::endl;
+        } else {
+            LCompilers::LPython::opt_remarks_to_diagnostics(remarks, diagnostics);
+        }
+    }
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!res.ok) {
         LCOMPILERS_ASSERT(diagnostics.has_error())
-        print_time_report(times, time_report);
+        print_time_report(report, time_report);
         return 3;
     }
     std::unique_ptr<LCompilers::LLVMModule> m = std::move(res.result);
@@ -1148,9 +1395,32 @@ int compile_python_using_llvm(
             call_stmts = true;
         }
 
-        e.add_module(std::move(m));
-        if (call_stmts) {
-            e.execfn<void>("__module___main_____main__global_stmts");
+        std::unique_ptr<LCompilers::LPython::CachingJIT> cached_jit;
+        if (!jit_cache_dir.empty()) {
+            std::string error;
+            cached_jit = LCompilers::LPython::CachingJIT::create(jit_cache_dir,
+                options_hash, error);
+            if (cached_jit && !cached_jit->add_module(*m->m_m, error)) {
+                cached_jit.reset();
+            }
+            if (!cached_jit && compiler_options.po.verbose) {
+                std::cerr << "JIT cache not used: " << error << std::endl;
+            }
+        }
+        if (cached_jit) {
+            if (call_stmts) {
+                void (*f)() = (void (*)())cached_jit->get_symbol_address(
+                    "__module___main_____main__global_stmts");
+                if (f == nullptr) {
+                    throw LCompilers::LCompilersException("CachingJIT: __module___main_____main__global_stmts not found");
+                }
+                f();
+            }
+        } else {
+            e.add_module(std::move(m));
+            if (call_stmts) {
+                e.execfn<void>("__module___main_____main__global_stmts");
+            }
         }
 
         if (compiler_options.po.enable_cpython) {
@@ -1162,19 +1432,275 @@ int compile_python_using_llvm(
 
         auto llvm_end = std::chrono::high_resolution_clock::now();
         times.push_back(std::make_pair("LLVM JIT execution", std::chrono::duration<double, std::milli>(llvm_end - llvm_start).count()));
-        print_time_report(times, time_report);
+        report.memory.push_back(LCompilers::LPython::get_memory_usage("LLVM JIT execution", al));
+        print_time_report(report, time_report);
     } else {
         auto llvm_start = std::chrono::high_resolution_clock::now();
-        e.save_object_file(*(m->m_m), outfile);
+        // With `--incremental` the imported modules go to their own object
+        // files, which are only regenerated if the module (or any module
+        // it imports) changed
+        if (incremental_dir.empty() || !LCompilers::LPython::save_incremental_object_files(
+                *asr, *(m->m_m), e, infile, outfile, incremental_dir,
+                options_hash, *module_objects)) {
+            e.save_object_file(*(m->m_m), outfile);
+        }
         auto llvm_end = std::chrono::high_resolution_clock::now();
         times.push_back(std::make_pair("LLVM to binary", std::chrono::duration<double, std::milli>(llvm_end - llvm_start).count()));
-        print_time_report(times, time_report);
+        report.memory.push_back(LCompilers::LPython::get_memory_usage("LLVM to binary", al));
+        print_time_report(report, time_report);
+    }
+    return 0;
+}
+
+/*
+    The modules that `m` imports at the top level, e.g., `a` and `b.c` for
+    `import a` and `from b.c import f`. Relative imports are skipped.
+*/
+std::vector<std::string> get_imported_modules(
+        const LCompilers::LPython::AST::Module_t &m) {
+    std::vector<std::string> modules;
+    namespace AST = LCompilers::LPython::AST;
+    for (size_t i = 0; i < m.n_body; i++) {
+        AST::stmt_t *stmt = m.m_body[i];
+        if (AST::is_a<AST::Import_t>(*stmt)) {
+            AST::Import_t *x = AST::down_cast<AST::Import_t>(stmt);
+            for (size_t j = 0; j < x->n_names; j++) {
+                modules.push_back(x->m_names[j].m_name);
+            }
+        } else if (AST::is_a<AST::ImportFrom_t>(*stmt)) {
+            AST::ImportFrom_t *x = AST::down_cast<AST::ImportFrom_t>(stmt);
+            if (x->m_module && x->m_level == 0) {
+                modules.push_back(x->m_module);
+            }
+        }
+    }
+    return modules;
+}
+
+/*
+    Compiles each of `infiles` to the corresponding object file in `outfiles`
+    using up to `jobs` threads. With `arg_c` every file is compiled exactly
+    as `lpython -c` would compile it on its own. Otherwise the first file is
+    the main program and the remaining ones are compiled as modules (as with
+    `--disable-main`) named after their file names, so that they can be
+    linked together.
+
+    All the files are parsed first, their imports give the order in which
+    they are compiled: a module is only compiled once the modules it imports
+    (among `infiles`) are, and the main program last. The `.pyc` file of
+    each module is written to `pyc_dir` (which is searched first for
+    imports) before it is imported, so that only its declarations are
+    loaded and its code is not compiled again into the importing object
+    file, wherever its source file is. Modules that do not depend on each
+    other are compiled concurrently.
+
+    Returns the error code of the first file (in the command line order)
+    that failed to compile.
+*/
+int compile_python_files_using_llvm(
+        const std::vector<std::string> &infiles,
+        const std::vector<std::string> &outfiles,
+        const std::string &runtime_library_dir,
+        LCompilers::PassManager& pass_manager,
+        CompilerOptions &compiler_options,
+        bool time_report, bool arg_c, size_t jobs,
+        const std::string &pyc_dir)
+{
+    LCOMPILERS_ASSERT(infiles.size() == outfiles.size());
+    size_t n = infiles.size();
+    jobs = std::max<size_t>(1, std::min(jobs, n));
+    std::vector<int> errors(n, 0);
+    std::vector<bool> compiled(n, false);
+    // The files that can only be compiled after file `i`, and the number of
+    // files that file `i` still waits for
+    std::vector<std::vector<size_t>> dependents(n);
+    std::vector<size_t> n_waiting(n, 0);
+    // With `arg_c` the files are independent, each is parsed when compiled
+    std::vector<std::unique_ptr<ParsedPythonFile>> parsed(n);
+    if (!arg_c) {
+        std::atomic<size_t> next_file(0);
+        auto parse_files = [&]() {
+            for (size_t i = next_file++; i < n; i = next_file++) {
+                parsed[i] = std::make_unique<ParsedPythonFile>();
+                parse_python_file(infiles[i], *parsed[i]);
+            }
+        };
+        std::vector<std::thread> parsers;
+        for (size_t i = 1; i < jobs; i++) {
+            parsers.emplace_back(parse_files);
+        }
+        parse_files();
+        for (auto &t: parsers) {
+            t.join();
+        }
+
+        std::map<std::string, size_t> module_files;
+        for (size_t i = 1; i < n; i++) {
+            module_files[remove_path(remove_extension(infiles[i]))] = i;
+        }
+        for (size_t i = 1; i < n; i++) {
+            std::set<size_t> imported;
+            // A file that failed to parse reports it when it is compiled
+            std::vector<std::string> modules;
+            if (parsed[i]->ast) {
+                modules = get_imported_modules(*parsed[i]->ast);
+            }
+            for (auto &module_name: modules) {
+                auto it = module_files.find(module_name);
+                if (it != module_files.end() && it->second != i) {
+                    imported.insert(it->second);
+                }
+            }
+            for (size_t j: imported) {
+                dependents[j].push_back(i);
+                n_waiting[i]++;
+            }
+            dependents[i].push_back(0);
+            n_waiting[0]++;
+        }
+    }
+
+    auto compile_file = [&](size_t i) -> int {
+        CompilerOptions file_options = compiler_options;
+        std::string module_name = "__main__";
+        bool file_arg_c = arg_c;
+        if (!arg_c) {
+            file_options.import_paths.insert(file_options.import_paths.begin(),
+                pyc_dir);
+            if (i > 0) {
+                module_name = remove_path(remove_extension(infiles[i]));
+                file_options.po.disable_main = true;
+                file_arg_c = true;
+            }
+        }
+        try {
+            int err = compile_python_using_llvm(infiles[i], outfiles[i],
+                runtime_library_dir, pass_manager, file_options,
+                time_report, file_arg_c, false, module_name, "", nullptr,
+                parsed[i].get(), pyc_dir);
+            // The importers load a module from its `.pyc` file, so the
+            // arena of the file is not needed anymore
+            parsed[i].reset();
+            return err;
+        } catch (const LCompilers::LCompilersException &e) {
+            std::cerr << "Internal Compiler Error while compiling "
+                << infiles[i] << ": " << e.name() + ": " << e.msg() << std::endl;
+        } catch (const std::exception &e) {
+            std::cerr << "std::exception while compiling " << infiles[i]
+                << ": " << e.what() << std::endl;
+        }
+        return 1;
+    };
+
+    std::mutex queue_mutex;
+    std::condition_variable queue_changed;
+    // The files that can be compiled now, the last one first
+    std::vector<size_t> ready;
+    size_t running = 0;
+    for (size_t i = n; i-- > 0;) {
+        if (n_waiting[i] == 0) ready.push_back(i);
+    }
+    auto worker = [&]() {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        while (true) {
+            queue_changed.wait(lock, [&]() {
+                return !ready.empty() || running == 0;
+            });
+            if (ready.empty()) {
+                // Nothing left that can be compiled
+                break;
+            }
+            size_t i = ready.back();
+            ready.pop_back();
+            running++;
+            lock.unlock();
+            int err = compile_file(i);
+            lock.lock();
+            running--;
+            errors[i] = err;
+            compiled[i] = true;
+            if (err == 0) {
+                for (size_t j: dependents[i]) {
+                    if (--n_waiting[j] == 0) ready.push_back(j);
+                }
+            }
+            queue_changed.notify_all();
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < jobs; i++) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto &t: workers) {
+        t.join();
+    }
+    for (int err: errors) {
+        if (err != 0) return err;
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (!compiled[i]) {
+            // No file failed, so the remaining ones import each other
+            std::cerr << "The modules given on the command line import each "
+                "other in a cycle, '" << infiles[i] << "' cannot be compiled"
+                << std::endl;
+            return 1;
+        }
     }
     return 0;
 }
 
 #endif
 
+/*
+    Compiles the modules of the runtime library and writes their ASR to
+    `outfile`, see `LCompilers::LPython::write_asr_bundle`.
+*/
+int generate_runtime_bundle(const std::string &outfile,
+        CompilerOptions &compiler_options) {
+    LCompilers::LPython::start_asr_bundle();
+    // `lpython_builtin` is also loaded implicitly (as intrinsic) by all the
+    // others, `numpy` is `lpython_intrinsic_numpy.py`
+    std::vector<std::string> runtime_modules = {"lpython_builtin", "math",
+        "cmath", "numpy", "os", "platform", "random", "statistics", "string",
+        "sys", "time"};
+    for (auto &module_name: runtime_modules) {
+        Allocator al(4*1024);
+        LCompilers::diag::Diagnostics diagnostics;
+        LCompilers::LocationManager lm;
+        std::string input = "import " + module_name + "\n";
+        {
+            LCompilers::LocationManager::FileLocations fl;
+            fl.in_filename = "runtime_bundle.py";
+            lm.files.push_back(fl);
+            lm.init_simple(input);
+            lm.file_ends.push_back(input.size());
+        }
+        LCompilers::Result<LCompilers::LPython::AST::Module_t*> ast
+            = LCompilers::LPython::parse(al, input, 0, diagnostics);
+        if (!ast.ok) {
+            std::cerr << diagnostics.render(lm, compiler_options);
+            return 1;
+        }
+        LCompilers::Result<LCompilers::ASR::TranslationUnit_t*>
+            asr = LCompilers::LPython::python_ast_to_asr(al, lm, nullptr,
+                *(LCompilers::LPython::AST::ast_t*)ast.result, diagnostics,
+                compiler_options, true, "__main__", "runtime_bundle.py");
+        if (!asr.ok) {
+            // The module is not bundled, it will be compiled when imported
+            std::cerr << "warning: the runtime module '" << module_name
+                << "' could not be compiled, it will not be part of the bundle"
+                << std::endl;
+            std::cerr << diagnostics.render(lm, compiler_options);
+        }
+    }
+    if (!LCompilers::LPython::write_asr_bundle(outfile)) {
+        std::cerr << "Could not write the runtime bundle to " << outfile << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
 void do_print_rtl_header_dir() {
     std::string rtl_header_dir = LCompilers::LPython::get_runtime_library_header_dir();
     std::cout << rtl_header_dir << std::endl;
@@ -1195,7 +1721,9 @@ int compile_to_binary_wasm(
     Allocator al(4*1024);
     LCompilers::diag::Diagnostics diagnostics;
     LCompilers::LocationManager lm;
-    std::vector<std::pair<std::string, double>>times;
+    LCompilers::LPython::CompilationReport report;
+    report.filename = infile;
+    std::vector<std::pair<std::string, double>> &times = report.times;
     {
         LCompilers::LocationManager::FileLocations fl;
         fl.in_filename = infile;
@@ -1215,9 +1743,10 @@ int compile_to_binary_wasm(
         al, runtime_library_dir, infile, diagnostics, 0, compiler_options.new_parser);
     auto parsing_end = std::chrono::high_resolution_clock::now();
     times.push_back(std::make_pair("Parsing", std::chrono::duration<double, std::milli>(parsing_end - parsing_start).count()));
+    report.memory.push_back(LCompilers::LPython::get_memory_usage("Parsing", al));
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!r.ok) {
-        print_time_report(times, time_report);
+        print_time_report(report, time_report);
         return 1;
     }
 
@@ -1229,10 +1758,11 @@ int compile_to_binary_wasm(
         r1 = LCompilers::LPython::python_ast_to_asr(al, lm, nullptr, *ast, diagnostics, compiler_options, true, "__main__", infile);
     auto ast_to_asr_end = std::chrono::high_resolution_clock::now();
     times.push_back(std::make_pair("AST to ASR", std::chrono::duration<double, std::milli>(ast_to_asr_end - ast_to_asr_start).count()));
+    report.memory.push_back(LCompilers::LPython::get_memory_usage("AST to ASR", al));
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!r1.ok) {
         LCOMPILERS_ASSERT(diagnostics.has_error())
-        print_time_report(times, time_report);
+        print_time_report(report, time_report);
         return 2;
     }
     LCompilers::ASR::TranslationUnit_t* asr = r1.result;
@@ -1249,8 +1779,9 @@ int compile_to_binary_wasm(
     LCompilers::Result<int> res = LCompilers::asr_to_wasm(*asr, al,  outfile, time_report, diagnostics, compiler_options);
     auto asr_to_wasm_end = std::chrono::high_resolution_clock::now();
     times.push_back(std::make_pair("ASR to WASM", std::chrono::duration<double, std::milli>(asr_to_wasm_end - asr_to_wasm_start).count()));
+    report.memory.push_back(LCompilers::LPython::get_memory_usage("ASR to WASM", al));
     std::cerr << diagnostics.render(lm, compiler_options);
-    print_time_report(times, time_report);
+    print_time_report(report, time_report);
     if (!res.ok) {
         LCOMPILERS_ASSERT(diagnostics.has_error())
         return 3;
@@ -1268,7 +1799,9 @@ int compile_to_binary_x86(
     Allocator al(4*1024);
     LCompilers::diag::Diagnostics diagnostics;
     LCompilers::LocationManager lm;
-    std::vector<std::pair<std::string, double>>times;
+    LCompilers::LPython::CompilationReport report;
+    report.filename = infile;
+    std::vector<std::pair<std::string, double>> &times = report.times;
     {
         LCompilers::LocationManager::FileLocations fl;
         fl.in_filename = infile;
@@ -1288,9 +1821,10 @@ int compile_to_binary_x86(
         al, runtime_library_dir, infile, diagnostics, 0, compiler_options.new_parser);
     auto parsing_end = std::chrono::high_resolution_clock::now();
     times.push_back(std::make_pair("Parsing", std::chrono::duration<double, std::milli>(parsing_end - parsing_start).count()));
+    report.memory.push_back(LCompilers::LPython::get_memory_usage("Parsing", al));
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!r.ok) {
-        print_time_report(times, time_report);
+        print_time_report(report, time_report);
         return 1;
     }
 
@@ -1302,10 +1836,11 @@ int compile_to_binary_x86(
         r1 = LCompilers::LPython::python_ast_to_asr(al, lm, nullptr, *ast, diagnostics, compiler_options, true, "__main__", infile);
     auto ast_to_asr_end = std::chrono::high_resolution_clock::now();
     times.push_back(std::make_pair("AST to ASR", std::chrono::duration<double, std::milli>(ast_to_asr_end - ast_to_asr_start).count()));
+    report.memory.push_back(LCompilers::LPython::get_memory_usage("AST to ASR", al));
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!r1.ok) {
         LCOMPILERS_ASSERT(diagnostics.has_error())
-        print_time_report(times, time_report);
+        print_time_report(report, time_report);
         return 2;
     }
     LCompilers::ASR::TranslationUnit_t* asr = r1.result;
@@ -1322,8 +1857,9 @@ int compile_to_binary_x86(
     LCompilers::Result<int> r3 = LCompilers::asr_to_x86(*asr, al, outfile, time_report, diagnostics);
     auto asr_to_x86_end = std::chrono::high_resolution_clock::now();
     times.push_back(std::make_pair("ASR to X86", std::chrono::duration<double, std::milli>(asr_to_x86_end - asr_to_x86_start).count()));
+    report.memory.push_back(LCompilers::LPython::get_memory_usage("ASR to X86", al));
     std::cerr << diagnostics.render(lm, compiler_options);
-    print_time_report(times, time_report);
+    print_time_report(report, time_report);
     if (!r3.ok) {
         LCOMPILERS_ASSERT(diagnostics.has_error())
         return 3;
@@ -1342,7 +1878,9 @@ int compile_to_binary_wasm_to_x86(
     Allocator al(4*1024);
     LCompilers::diag::Diagnostics diagnostics;
     LCompilers::LocationManager lm;
-    std::vector<std::pair<std::string, double>>times;
+    LCompilers::LPython::CompilationReport report;
+    report.filename = infile;
+    std::vector<std::pair<std::string, double>> &times = report.times;
     {
         LCompilers::LocationManager::FileLocations fl;
         fl.in_filename = infile;
@@ -1362,9 +1900,10 @@ int compile_to_binary_wasm_to_x86(
         al, runtime_library_dir, infile, diagnostics, 0, compiler_options.new_parser);
     auto parsing_end = std::chrono::high_resolution_clock::now();
     times.push_back(std::make_pair("Parsing", std::chrono::duration<double, std::milli>(parsing_end - parsing_start).count()));
+    report.memory.push_back(LCompilers::LPython::get_memory_usage("Parsing", al));
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!r.ok) {
-        print_time_report(times, time_report);
+        print_time_report(report, time_report);
         return 1;
     }
 
@@ -1376,10 +1915,11 @@ int compile_to_binary_wasm_to_x86(
         r1 = LCompilers::LPython::python_ast_to_asr(al, lm, nullptr, *ast, diagnostics, compiler_options, true, "__main__", infile);
     auto ast_to_asr_end = std::chrono::high_resolution_clock::now();
     times.push_back(std::make_pair("AST to ASR", std::chrono::duration<double, std::milli>(ast_to_asr_end - ast_to_asr_start).count()));
+    report.memory.push_back(LCompilers::LPython::get_memory_usage("AST to ASR", al));
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!r1.ok) {
         LCOMPILERS_ASSERT(diagnostics.has_error())
-        print_time_report(times, time_report);
+        print_time_report(report, time_report);
         return 2;
     }
     LCompilers::ASR::TranslationUnit_t* asr = r1.result;
@@ -1396,10 +1936,11 @@ int compile_to_binary_wasm_to_x86(
     LCompilers::Result<LCompilers::Vec<uint8_t>> r3 = LCompilers::asr_to_wasm_bytes_stream(*asr, al, diagnostics, compiler_options);
     auto asr_to_wasm_end = std::chrono::high_resolution_clock::now();
     times.push_back(std::make_pair("ASR to WASM", std::chrono::duration<double, std::milli>(asr_to_wasm_end - asr_to_wasm_start).count()));
+    report.memory.push_back(LCompilers::LPython::get_memory_usage("ASR to WASM", al));
     std::cerr << diagnostics.render(lm, compiler_options);
     if (!r3.ok) {
         LCOMPILERS_ASSERT(diagnostics.has_error())
-        print_time_report(times, time_report);
+        print_time_report(report, time_report);
         return 3;
     }
 
@@ -1410,6 +1951,7 @@ int compile_to_binary_wasm_to_x86(
         LCompilers::Result<int> res = LCompilers::wasm_to_x86(r3.result, al,  outfile, time_report, diagnostics);
         auto wasm_to_x86_end = std::chrono::high_resolution_clock::now();
         times.push_back(std::make_pair("WASM to X86", std::chrono::duration<double, std::milli>(wasm_to_x86_end - wasm_to_x86_start).count()));
+        report.memory.push_back(LCompilers::LPython::get_memory_usage("WASM to X86", al));
         is_result_ok = res.ok;
     } else {
         // WASM -> X64
@@ -1417,11 +1959,12 @@ int compile_to_binary_wasm_to_x86(
         LCompilers::Result<int> res = LCompilers::wasm_to_x64(r3.result, al,  outfile, time_report, diagnostics);
         auto wasm_to_x64_end = std::chrono::high_resolution_clock::now();
         times.push_back(std::make_pair("WASM to X64", std::chrono::duration<double, std::milli>(wasm_to_x64_end - wasm_to_x64_start).count()));
+        report.memory.push_back(LCompilers::LPython::get_memory_usage("WASM to X64", al));
         is_result_ok = res.ok;
     }
 
     std::cerr << diagnostics.render(lm, compiler_options);
-    print_time_report(times, time_report);
+    print_time_report(report, time_report);
     if (!is_result_ok) {
         LCOMPILERS_ASSERT(diagnostics.has_error())
         return 4;
@@ -1511,6 +2054,28 @@ int link_executable(const std::vector<std::string> &infiles,
                 return 10;
             }
         } else {
+#ifdef HAVE_LPYTHON_LLD
+            // Link in-process with LLD (the `ld` approach described above).
+            // Anything that needs extra libraries, or an explicitly requested
+            // compiler driver, still goes through `cc` below.
+            bool use_lld = std::getenv("LFORTRAN_CC") == nullptr
+                && !compiler_options.enable_symengine
+                && !compiler_options.po.enable_cpython;
+            for (auto &s : infiles) {
+                if (!endswith(s, ".o")) use_lld = false;
+            }
+            if (use_lld) {
+                std::string error;
+                if (LCompilers::LPython::lld_link_executable(infiles, outfile,
+                        runtime_library_dir, t, static_executable, error)) {
+                    return 0;
+                }
+                if (compiler_options.po.verbose) {
+                    std::cerr << error << std::endl
+                        << "Falling back to linking with `cc`" << std::endl;
+                }
+            }
+#endif
             std::string CC = "cc";
             char *env_CC = std::getenv("LFORTRAN_CC");
             if (env_CC) CC = env_CC;
@@ -1811,6 +2376,7 @@ int main(int argc, char *argv[])
         bool arg_S = false;
         bool arg_c = false;
         bool arg_v = false;
+        size_t arg_jobs = std::max(1u, std::thread::hardware_concurrency());
         // bool arg_E = false;
         // std::string arg_J;
         // std::vector<std::string> arg_I;
@@ -1835,7 +2401,11 @@ int main(int argc, char *argv[])
         bool show_asm = false;
         bool show_wat = false;
         bool time_report = false;
+        std::string arg_time_report;
+        std::string arg_opt_remarks;
         bool static_link = false;
+        bool no_runtime_lto = false;
+        bool incremental = false;
         std::string arg_backend = "llvm";
         std::string arg_kernel_f;
         bool print_targets = false;
@@ -1858,6 +2428,9 @@ int main(int argc, char *argv[])
 
         std::string arg_pywrap_file;
         std::string arg_pywrap_array_order="f";
+        std::string arg_asr_cache_dir;
+        std::string arg_ast_cache_dir;
+        std::string arg_runtime_bundle;
 
         CompilerOptions compiler_options;
         LCompilers::PassManager lpython_pass_manager;
@@ -1872,6 +2445,8 @@ int main(int argc, char *argv[])
         app.add_flag("-c", arg_c, "Compile and assemble, do not link");
         app.add_option("-o", compiler_options.arg_o, "Specify the file to place the output into");
         app.add_flag("-v", arg_v, "Be more verbose");
+        app.add_option("-j", arg_jobs, "Number of input files to compile in parallel")->capture_default_str();
+        app.add_option("--parse-jobs", parse_jobs, "Number of threads to parse a large file with (split at its top level definitions)")->capture_default_str();
         // app.add_flag("-E", arg_E, "Preprocess only; do not compile, assemble or link");
         // app.add_option("-l", arg_l, "Link library option");
         // app.add_option("-L", arg_L, "Library path option");
@@ -1909,7 +2484,9 @@ int main(int argc, char *argv[])
         app.add_option("--skip-pass", skip_pass, "Skip an ASR pass in default pipeline");
         app.add_flag("--disable-main", compiler_options.po.disable_main, "Do not generate any code for the `main` function");
         app.add_flag("--symtab-only", compiler_options.symtab_only, "Only create symbol tables in ASR (skip executable stmt)");
-        app.add_flag("--time-report", time_report, "Show compilation time report");
+        app.add_flag("--time-report{text}", arg_time_report, "Show compilation time report (--time-report=json for JSON output)");
+        app.add_flag("--mem-report", mem_report, "Show the memory used after each compilation stage (arena; heap and peak RSS of the whole process)");
+        app.add_flag("--opt-remarks{text}", arg_opt_remarks, "Show the decisions of the optimizations done with --fast at the Python source (--opt-remarks=json for JSON output)");
         app.add_flag("--static", static_link, "Create a static executable");
         app.add_flag("--no-warnings", disable_warnings, "Turn off all warnings");
         app.add_flag("--no-error-banner", hide_error_banner, "Turn off error banner");
@@ -1917,6 +2494,12 @@ int main(int argc, char *argv[])
         app.add_flag("--enable-bounds-checking", compiler_options.bounds_checking, "Turn on index bounds checking");
         app.add_flag("--openmp", compiler_options.openmp, "Enable openmp");
         app.add_flag("--fast", compiler_options.po.fast, "Best performance (disable strict standard compliance)");
+        app.add_flag("--profile-generate", profile_generate, "Instrument the executable to write a profile (LPYTHON_PROFILE_FILE, lpython.prof by default) at exit");
+        app.add_option("--profile-use", profile_use, "Optimize using the profile written by an executable built with --profile-generate");
+        app.add_option("--multiversion", multiversion, "Also compile the functions with array loops for these ISA levels (avx2, avx512), selected at load time")->delimiter(',');
+        app.add_option("--jit-cache-dir", jit_cache_dir, "Cache the machine code generated by --jit in this directory");
+        app.add_flag("--incremental", incremental, "Reuse the object files of the unchanged imported modules from the previous build");
+        app.add_flag("--no-runtime-lto", no_runtime_lto, "Do not inline the runtime library into the code with --fast");
         app.add_option("--target", compiler_options.target, "Generate code for the given target")->capture_default_str();
         app.add_flag("--print-targets", print_targets, "Print the registered targets");
         app.add_flag("--get-rtl-header-dir", print_rtl_header_dir, "Print the path to the runtime library header file");
@@ -1933,6 +2516,9 @@ int main(int argc, char *argv[])
         app.add_flag("--global-mangling", compiler_options.po.global_symbols_mangling, "Mangles all the global symbols");
         app.add_flag("--intrinsic-mangling", compiler_options.po.intrinsic_symbols_mangling, "Mangles all the intrinsic symbols");
         app.add_flag("--all-mangling", compiler_options.po.all_symbols_mangling, "Mangles all possible symbols");
+        app.add_option("--asr-cache-dir", arg_asr_cache_dir, "Cache the ASR of imported modules in the given directory (default: $LPYTHON_ASR_CACHE_DIR)");
+        app.add_option("--ast-cache-dir", arg_ast_cache_dir, "Cache the AST of parsed files in the given directory (default: $LPYTHON_AST_CACHE_DIR)");
+        app.add_option("--generate-runtime-bundle", arg_runtime_bundle, "Write the ASR of the runtime library modules to the given file and exit");
 
         // LSP specific options
         app.add_flag("--show-errors", show_errors, "Show errors when LSP is running in the background");
@@ -1972,6 +2558,39 @@ int main(int argc, char *argv[])
 
         lcompilers_unique_ID_separate_compilation = separate_compilation ? LCompilers::get_unique_ID(): "";
 
+        if (arg_time_report.size() > 0) {
+            if (arg_time_report != "text" && arg_time_report != "json") {
+                std::cerr << "The --time-report format must be one of: text, json." << std::endl;
+                return 1;
+            }
+            time_report = true;
+            time_report_json = (arg_time_report == "json");
+        }
+        if (arg_opt_remarks.size() > 0) {
+            if (arg_opt_remarks != "text" && arg_opt_remarks != "json") {
+                std::cerr << "The --opt-remarks format must be one of: text, json." << std::endl;
+                return 1;
+            }
+            opt_remarks = true;
+            opt_remarks_json = (arg_opt_remarks == "json");
+        }
+
+        if (arg_asr_cache_dir.size() > 0) {
+            LCompilers::LPython::set_asr_cache_dir(arg_asr_cache_dir);
+        }
+        if (arg_ast_cache_dir.size() > 0) {
+            LCompilers::LPython::set_ast_cache_dir(arg_ast_cache_dir);
+        }
+        runtime_lto = !no_runtime_lto;
+        if (profile_generate && !profile_use.empty()) {
+            std::cerr << "The options --profile-generate and --profile-use cannot be used together." << std::endl;
+            return 1;
+        }
+        if (jit_cache_dir.empty()) {
+            char *env_p = std::getenv("LPYTHON_JIT_CACHE_DIR");
+            if (env_p) jit_cache_dir = env_p;
+        }
+
 
         if( compiler_options.po.fast && compiler_options.bounds_checking ) {
         // ReleaseSafe Mode
@@ -2028,6 +2647,10 @@ int main(int argc, char *argv[])
             return 0;
         }
 
+        if (arg_runtime_bundle.size() > 0) {
+            return generate_runtime_bundle(arg_runtime_bundle, compiler_options);
+        }
+
         compiler_options.use_colors = !arg_no_color;
         compiler_options.indent = !arg_no_indent;
 
@@ -2094,12 +2717,15 @@ int main(int argc, char *argv[])
 #endif
         }
 
-        // TODO: for now we ignore the other filenames, only handle
-        // the first:
+        // The options that emit an intermediate representation only handle
+        // the first file, compiling and linking handles all of them (see
+        // `compile_python_files_using_llvm` below)
         std::string arg_file = arg_files[0];
-        if (CLI::NonexistentPath(arg_file).empty()){
-            std::cerr << "The input file does not exist: " << arg_file << std::endl;
-            return 1;
+        for (auto &file: arg_files) {
+            if (CLI::NonexistentPath(file).empty()){
+                std::cerr << "The input file does not exist: " << file << std::endl;
+                return 1;
+            }
         }
 
         std::string outfile;
@@ -2126,6 +2752,16 @@ int main(int argc, char *argv[])
             outfile = basename + ".out";
         }
 
+        std::string incremental_dir;
+        if (incremental) {
+            incremental_dir = outfile + ".incremental";
+            LCompilers::LPython::create_directory(incremental_dir);
+            // Unchanged modules also do not need to be compiled to ASR again
+            if (LCompilers::LPython::get_asr_cache_dir().empty()) {
+                LCompilers::LPython::set_asr_cache_dir(incremental_dir + "/asr");
+            }
+        }
+
         if (compiler_options.po.dump_fortran || compiler_options.po.dump_all_passes) {
             dump_all_passes(arg_file, runtime_library_dir, compiler_options);
         }
@@ -2201,6 +2837,80 @@ int main(int argc, char *argv[])
             }
         }
 
+        if (arg_files.size() > 1 && endswith(arg_file, ".py") && !to_jit) {
+            if (backend != Backend::llvm) {
+                std::cerr << "Compiling multiple input files is only supported by the LLVM backend." << std::endl;
+                return 1;
+            }
+#ifdef HAVE_LFORTRAN_LLVM
+            if (arg_c && compiler_options.arg_o.size() > 0) {
+                std::cerr << "The -o option cannot be used with -c and multiple input files." << std::endl;
+                return 1;
+            }
+            std::vector<std::string> py_files, object_files, link_files;
+            for (auto &file: arg_files) {
+                if (endswith(file, ".py")) {
+                    py_files.push_back(file);
+                    std::string file_basename = remove_path(remove_extension(file));
+                    if (arg_c) {
+                        object_files.push_back(file_basename + ".o");
+                    } else {
+                        object_files.push_back(outfile + "." + file_basename + ".tmp.o");
+                        link_files.push_back(object_files.back());
+                    }
+                } else if (!arg_c) {
+                    link_files.push_back(file);
+                }
+            }
+            // The `.pyc` files of the modules are private to this build, so
+            // they never end up next to the sources
+            std::string pyc_dir;
+            if (!arg_c) {
+                pyc_dir = outfile + ".modules.tmp";
+                if (!LCompilers::LPython::create_directory(pyc_dir)) {
+                    std::cerr << "The directory '" << pyc_dir << "' cannot be created." << std::endl;
+                    return 1;
+                }
+            }
+            int err = compile_python_files_using_llvm(py_files, object_files,
+                runtime_library_dir, lpython_pass_manager, compiler_options,
+                time_report, arg_c, arg_jobs, pyc_dir);
+            if (arg_c) return err;
+            for (size_t i = 1; i < py_files.size(); i++) {
+                std::string pyc_file = pyc_dir + "/"
+                    + remove_path(remove_extension(py_files[i])) + ".pyc";
+                std::remove(pyc_file.c_str());
+            }
+            LCompilers::LPython::remove_directory(pyc_dir);
+            if (err == 0) {
+                err = link_executable(link_files, outfile, runtime_library_dir,
+                    backend, static_link, true, compiler_options, rtlib_header_dir);
+            }
+            for (auto &object_file: object_files) {
+                std::remove(object_file.c_str());
+            }
+            if (err != 0) return err;
+            if (compiler_options.arg_o == "") {
+                if (compiler_options.platform == LCompilers::Platform::Windows) {
+                    return system(outfile.c_str());
+                } else {
+                    err = system(("./" + outfile).c_str());
+                }
+                if (err != 0) {
+                    if (0 < err && err < 256) {
+                        return err;
+                    } else {
+                        return LCompilers::LPython::get_exit_status(err);
+                    }
+                }
+            }
+            return 0;
+#else
+            std::cerr << "Compiling multiple Python files requires the LLVM backend to be enabled. Recompile with `WITH_LLVM=yes`." << std::endl;
+            return 1;
+#endif
+        }
+
         if (arg_c && !to_jit) {
             if (backend == Backend::llvm) {
 #ifdef HAVE_LFORTRAN_LLVM
@@ -2255,10 +2965,12 @@ int main(int argc, char *argv[])
             } else if (backend == Backend::llvm) {
 #ifdef HAVE_LFORTRAN_LLVM
                 std::string tmp_o = outfile + ".tmp.o";
+                std::vector<std::string> link_files = {tmp_o};
                 err = compile_python_using_llvm(arg_file, tmp_o, runtime_library_dir,
-                    lpython_pass_manager, compiler_options, time_report);
+                    lpython_pass_manager, compiler_options, time_report,
+                    false, false, "__main__", incremental_dir, &link_files);
                 if (err != 0) return err;
-                err = link_executable({tmp_o}, outfile, runtime_library_dir,
+                err = link_executable(link_files, outfile, runtime_library_dir,
                     backend, static_link, true, compiler_options, rtlib_header_dir);
 
 #ifdef HAVE_RUNTIME_STACKTRACE
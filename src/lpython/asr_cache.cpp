@@ -0,0 +1,363 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string_view>
+
+#ifdef _WIN32
+    #include <process.h>
+    #define getpid _getpid
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <libasr/config.h>
+#include <libasr/string_utils.h>
+#include <libasr/utils.h>
+#include <lpython/asr_cache.h>
+#include <lpython/utils.h>
+
+namespace LCompilers::LPython {
+
+namespace {
+
+    const std::string asr_cache_magic = "LPython ASR cache";
+    const std::string asr_bundle_magic = "LPython ASR bundle";
+    // Paths inside the runtime library directory are stored relative to it,
+    // so that the bundle (and the cache) keep working after installation
+    const std::string runtime_dir_prefix = "$rtlib/";
+
+    std::string asr_cache_dir;
+    bool asr_cache_dir_set = false;
+
+    struct RegisteredModule {
+        ASRCacheModule module;
+        std::vector<std::string> dependencies;
+    };
+
+    std::map<std::string, RegisteredModule> registered_modules;
+
+    // Hashes of the source files already checked in this process
+    std::map<std::string, uint64_t> file_hashes;
+
+    // Entries recorded by `start_asr_bundle`
+    bool recording_bundle = false;
+    std::map<std::string, std::string> bundle_entries;
+
+    // The runtime bundle, mapped on first use
+    struct RuntimeBundle {
+        bool loaded = false;
+        const char *data = nullptr;
+        size_t size = 0;
+        std::string contents; // Only used if the file cannot be mapped
+        std::map<std::string, std::string_view> entries;
+    } runtime_bundle;
+
+    std::string get_runtime_dir_with_slash() {
+        std::string dir = get_runtime_library_dir();
+        if (dir.empty() || dir.back() != '/') dir += "/";
+        return dir;
+    }
+
+    std::string normalize_path(const std::string &path) {
+        std::string dir = get_runtime_dir_with_slash();
+        if (startswith(path, dir)) {
+            return runtime_dir_prefix + path.substr(dir.size());
+        }
+        return path;
+    }
+
+    std::string expand_path(const std::string &path) {
+        if (startswith(path, runtime_dir_prefix)) {
+            return get_runtime_dir_with_slash() + path.substr(runtime_dir_prefix.size());
+        }
+        return path;
+    }
+
+    bool get_file_hash(const std::string &path, uint64_t &hash) {
+        auto it = file_hashes.find(path);
+        if (it != file_hashes.end()) {
+            hash = it->second;
+            return true;
+        }
+        std::string input;
+        if (!read_file(path, input)) return false;
+        hash = fnv1a_hash(input);
+        file_hashes[path] = hash;
+        return true;
+    }
+
+    std::string get_entry_name(const std::string &module_name,
+            const std::string &path) {
+        return module_name + " " + normalize_path(path);
+    }
+
+    std::string get_entry_filename(const std::string &module_name,
+            const std::string &path) {
+        return asr_cache_dir + "/" + module_name + "-"
+            + hash_to_hex(fnv1a_hash(normalize_path(path))) + ".lpyc";
+    }
+
+    std::string format_entry(uint64_t key, const ASRCacheEntry &entry) {
+        std::string s = asr_cache_magic + " " + LFORTRAN_VERSION + "\n";
+        s += "key " + hash_to_hex(key) + "\n";
+        s += "source " + std::to_string(entry.source.size()) + "\n";
+        for (auto &m: entry.dependencies) {
+            s += "dep " + hash_to_hex(m.hash) + " " + (m.intrinsic ? "1" : "0")
+                + " " + m.name + " " + m.import_name + " "
+                + normalize_path(m.path) + "\n";
+        }
+        s += "end\n";
+        s += entry.source;
+        s += entry.asr;
+        return s;
+    }
+
+    bool parse_entry(std::string_view s, uint64_t key,
+            const std::string &source, ASRCacheEntry &entry) {
+        size_t header_end = s.find("\nend\n");
+        if (header_end == std::string::npos) return false;
+        std::istringstream header(std::string(s.substr(0, header_end)));
+        std::string line;
+        if (!std::getline(header, line) || line != asr_cache_magic + " " + LFORTRAN_VERSION) {
+            return false;
+        }
+        if (!std::getline(header, line) || line != "key " + hash_to_hex(key)) {
+            return false;
+        }
+        // The key only locates the entry, the source must be the same
+        if (!std::getline(header, line)
+                || line != "source " + std::to_string(source.size())) {
+            return false;
+        }
+        size_t source_start = header_end + 5;
+        if (s.size() - source_start < source.size()
+                || s.substr(source_start, source.size()) != source) {
+            return false;
+        }
+        entry.dependencies.clear();
+        while (std::getline(header, line)) {
+            // dep <hash> <intrinsic> <name> <import_name> <path>
+            std::istringstream dep(line);
+            std::string tag, hash;
+            ASRCacheModule m;
+            if (!(dep >> tag >> hash >> m.intrinsic >> m.name >> m.import_name)
+                    || tag != "dep") {
+                return false;
+            }
+            dep.get();
+            std::getline(dep, m.path);
+            m.path = expand_path(m.path);
+            m.hash = std::strtoull(hash.c_str(), nullptr, 16);
+            uint64_t current_hash;
+            if (!get_file_hash(m.path, current_hash) || current_hash != m.hash) {
+                // A dependency changed, the entry is stale
+                return false;
+            }
+            entry.dependencies.push_back(m);
+        }
+        entry.source = source;
+        entry.asr = std::string(s.substr(source_start + source.size()));
+        return true;
+    }
+
+    void load_runtime_bundle() {
+        runtime_bundle.loaded = true;
+        std::string filename = get_runtime_dir_with_slash() + "lpython_runtime.lpyb";
+#ifndef _WIN32
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            struct stat st;
+            if (fstat(fd, &st) == 0 && st.st_size > 0) {
+                void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p != MAP_FAILED) {
+                    // The mapping is kept for the lifetime of the process
+                    runtime_bundle.data = (const char*)p;
+                    runtime_bundle.size = st.st_size;
+                }
+            }
+            close(fd);
+        }
+#endif
+        if (runtime_bundle.data == nullptr) {
+            if (!read_file(filename, runtime_bundle.contents)) return;
+            runtime_bundle.data = runtime_bundle.contents.data();
+            runtime_bundle.size = runtime_bundle.contents.size();
+        }
+
+        // LPython ASR bundle <version>
+        // <name> <offset> <size> (one line per entry, the name contains a space)
+        // end
+        // <entries>
+        std::string_view s(runtime_bundle.data, runtime_bundle.size);
+        size_t header_end = s.find("\nend\n");
+        if (header_end == std::string::npos) return;
+        std::istringstream header(std::string(s.substr(0, header_end)));
+        std::string_view data = s.substr(header_end + 5);
+        std::string line;
+        if (!std::getline(header, line) || line != asr_bundle_magic + " " + LFORTRAN_VERSION) {
+            return;
+        }
+        while (std::getline(header, line)) {
+            std::istringstream e(line);
+            std::string module_name, path;
+            size_t offset, size;
+            if (!(e >> module_name >> path >> offset >> size)
+                    || offset + size > data.size()) {
+                runtime_bundle.entries.clear();
+                return;
+            }
+            runtime_bundle.entries[module_name + " " + path] = data.substr(offset, size);
+        }
+    }
+
+} // namespace
+
+void set_asr_cache_dir(const std::string &dir) {
+    asr_cache_dir = dir;
+    asr_cache_dir_set = true;
+}
+
+std::string get_asr_cache_dir() {
+    if (!asr_cache_dir_set) {
+        char *env_p = std::getenv("LPYTHON_ASR_CACHE_DIR");
+        if (env_p) asr_cache_dir = env_p;
+        asr_cache_dir_set = true;
+    }
+    return asr_cache_dir;
+}
+
+bool is_asr_cache_enabled() {
+    return recording_bundle || !get_asr_cache_dir().empty();
+}
+
+uint64_t get_asr_cache_key(const std::string &module_name,
+        const std::string &path, const std::string &source,
+        bool allow_implicit_casting) {
+    uint64_t h = fnv1a_hash(LFORTRAN_VERSION);
+    h = fnv1a_hash(module_name + '\0' + normalize_path(path) + '\0', h);
+    h = fnv1a_hash(std::string(allow_implicit_casting ? "1" : "0"), h);
+    return fnv1a_hash(source, h);
+}
+
+bool load_asr_cache_entry(const std::string &module_name,
+        const std::string &path, uint64_t key, const std::string &source,
+        ASRCacheEntry &entry) {
+    // The bundle is being (re)generated, everything must be compiled
+    if (recording_bundle) return false;
+    std::string name = get_entry_name(module_name, path);
+    if (startswith(name, module_name + " " + runtime_dir_prefix)) {
+        if (!runtime_bundle.loaded) load_runtime_bundle();
+        auto it = runtime_bundle.entries.find(name);
+        if (it != runtime_bundle.entries.end()
+                && parse_entry(it->second, key, source, entry)) {
+            return true;
+        }
+    }
+    if (get_asr_cache_dir().empty()) return false;
+    std::string s;
+    if (!read_file(get_entry_filename(module_name, path), s)) return false;
+    return parse_entry(s, key, source, entry);
+}
+
+void save_asr_cache_entry(const std::string &module_name,
+        const std::string &path, uint64_t key, const ASRCacheEntry &entry) {
+    std::string s = format_entry(key, entry);
+    if (recording_bundle) {
+        bundle_entries[get_entry_name(module_name, path)] = s;
+    }
+    std::string dir = get_asr_cache_dir();
+    if (dir.empty() || !create_directory(dir)) return;
+    std::string filename = get_entry_filename(module_name, path);
+    // Write to a temporary file first, so that a concurrent compilation
+    // never sees a partially written entry
+    std::string tmp_filename = filename + "." + std::to_string(getpid()) + ".tmp";
+    {
+        std::ofstream out(tmp_filename, std::ofstream::out | std::ofstream::binary);
+        if (!out) return;
+        out << s;
+        if (!out) {
+            out.close();
+            std::remove(tmp_filename.c_str());
+            return;
+        }
+    }
+    std::remove(filename.c_str());
+    if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+        std::remove(tmp_filename.c_str());
+    }
+}
+
+void start_asr_bundle() {
+    recording_bundle = true;
+    bundle_entries.clear();
+}
+
+bool write_asr_bundle(const std::string &filename) {
+    std::string header = asr_bundle_magic + " " + LFORTRAN_VERSION + "\n";
+    size_t offset = 0;
+    for (auto &entry: bundle_entries) {
+        // Only the runtime modules can be found by `load_asr_cache_entry`
+        if (!startswith(entry.first.substr(entry.first.find(' ') + 1),
+                runtime_dir_prefix)) {
+            continue;
+        }
+        header += entry.first + " " + std::to_string(offset) + " "
+            + std::to_string(entry.second.size()) + "\n";
+        offset += entry.second.size();
+    }
+    header += "end\n";
+    std::ofstream out(filename, std::ofstream::out | std::ofstream::binary);
+    if (!out) return false;
+    out << header;
+    for (auto &entry: bundle_entries) {
+        if (!startswith(entry.first.substr(entry.first.find(' ') + 1),
+                runtime_dir_prefix)) {
+            continue;
+        }
+        out << entry.second;
+    }
+    recording_bundle = false;
+    return (bool)out;
+}
+
+void register_asr_cache_module(const ASRCacheModule &module,
+        const std::vector<std::string> &dependencies) {
+    registered_modules[module.name] = {module, dependencies};
+    file_hashes[module.path] = module.hash;
+}
+
+bool get_asr_cache_module(const std::string &module_name,
+        ASRCacheModule &module, std::vector<std::string> &dependencies) {
+    auto it = registered_modules.find(module_name);
+    if (it == registered_modules.end()) return false;
+    module = it->second.module;
+    dependencies = it->second.dependencies;
+    return true;
+}
+
+bool collect_asr_cache_dependencies(const std::string &module_name,
+        const std::vector<std::string> &dependencies,
+        std::vector<ASRCacheModule> &modules) {
+    std::set<std::string> visited = {module_name};
+    std::vector<std::string> stack = dependencies;
+    while (!stack.empty()) {
+        std::string name = stack.back();
+        stack.pop_back();
+        if (visited.find(name) != visited.end()) continue;
+        visited.insert(name);
+        auto it = registered_modules.find(name);
+        if (it == registered_modules.end()) return false;
+        modules.push_back(it->second.module);
+        stack.insert(stack.end(), it->second.dependencies.begin(),
+            it->second.dependencies.end());
+    }
+    return true;
+}
+
+} // namespace LCompilers::LPython
@@ -0,0 +1,82 @@
+#ifndef LPYTHON_ASR_CACHE_H
+#define LPYTHON_ASR_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace LCompilers::LPython {
+
+    /*
+        Persistent cache of the ASR of imported modules.
+
+        Each entry stores the output of `save_pycfile` for a single module
+        together with its source and the modules it depends on. An entry is
+        only used if the hash of the module source, the compiler version and
+        the options that affect the semantics all match, the stored source
+        is the same as the current one, and none of the (transitive)
+        dependencies changed since the entry was written.
+
+        The cache is disabled unless a directory is given, either with
+        `set_asr_cache_dir` (`--asr-cache-dir`) or with the
+        `LPYTHON_ASR_CACHE_DIR` environment variable.
+
+        The modules of the runtime library are additionally looked up in
+        `lpython_runtime.lpyb` in the runtime library directory, a bundle of
+        entries generated at build time (`--generate-runtime-bundle`) that
+        is memory mapped on first use.
+    */
+
+    struct ASRCacheModule {
+        std::string name;        // Name of the module in the symbol table
+        std::string import_name; // Name that was passed to `load_module`
+        std::string path;        // Source file the module was compiled from
+        bool intrinsic;
+        uint64_t hash;           // Hash of the source file
+    };
+
+    struct ASRCacheEntry {
+        std::vector<ASRCacheModule> dependencies;
+        std::string source; // The key is only a hash, this is compared
+        std::string asr;
+    };
+
+    void set_asr_cache_dir(const std::string &dir);
+    std::string get_asr_cache_dir();
+    // True if the compiled modules should be stored
+    bool is_asr_cache_enabled();
+
+    uint64_t get_asr_cache_key(const std::string &module_name,
+        const std::string &path, const std::string &source,
+        bool allow_implicit_casting);
+
+    // Returns false if there is no valid entry for `path` with `key` that
+    // was compiled from `source`
+    bool load_asr_cache_entry(const std::string &module_name,
+        const std::string &path, uint64_t key, const std::string &source,
+        ASRCacheEntry &entry);
+    void save_asr_cache_entry(const std::string &module_name,
+        const std::string &path, uint64_t key, const ASRCacheEntry &entry);
+
+    // Records every entry saved from now on (and ignores all the existing
+    // ones), `write_asr_bundle` then writes those of the runtime modules
+    void start_asr_bundle();
+    bool write_asr_bundle(const std::string &filename);
+
+    // Remembers where a module loaded in this process comes from and which
+    // modules it directly depends on, so that the entries of the modules
+    // importing it can record it.
+    void register_asr_cache_module(const ASRCacheModule &module,
+        const std::vector<std::string> &dependencies);
+    // Returns false if no module called `module_name` was registered
+    bool get_asr_cache_module(const std::string &module_name,
+        ASRCacheModule &module, std::vector<std::string> &dependencies);
+    // Collects the transitive closure of `dependencies`. Returns false if
+    // any of them was not registered (e.g. it is not backed by a file).
+    bool collect_asr_cache_dependencies(const std::string &module_name,
+        const std::vector<std::string> &dependencies,
+        std::vector<ASRCacheModule> &modules);
+
+} // namespace LCompilers::LPython
+
+#endif // LPYTHON_ASR_CACHE_H
@@ -0,0 +1,129 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+    #include <process.h>
+    #define getpid _getpid
+#else
+    #include <unistd.h>
+#endif
+
+#include <libasr/config.h>
+#include <libasr/utils.h>
+#include <lpython/ast_cache.h>
+#include <lpython/bigint.h>
+#include <lpython/python_serialization.h>
+#include <lpython/utils.h>
+
+namespace LCompilers::LPython {
+
+namespace {
+
+    const std::string ast_cache_magic = "LPython AST cache";
+
+    std::string ast_cache_dir;
+    bool ast_cache_dir_set = false;
+
+    // Large integers are pointers to their digits in the arena
+    class LargeIntVisitor : public AST::BaseWalkVisitor<LargeIntVisitor>
+    {
+    public:
+        bool found = false;
+
+        void visit_ConstantInt(const AST::ConstantInt_t &x) {
+            if (BigInt::is_int_ptr(x.m_value)) found = true;
+        }
+    };
+
+    std::string get_entry_filename(uint64_t hash) {
+        return ast_cache_dir + "/" + hash_to_hex(hash) + ".lpyast";
+    }
+
+    std::string get_header(size_t size) {
+        return ast_cache_magic + " " + LFORTRAN_VERSION + "\n"
+            + "size " + std::to_string(size) + "\n";
+    }
+
+} // namespace
+
+void set_ast_cache_dir(const std::string &dir) {
+    ast_cache_dir = dir;
+    ast_cache_dir_set = true;
+}
+
+std::string get_ast_cache_dir() {
+    if (!ast_cache_dir_set) {
+        char *env_p = std::getenv("LPYTHON_AST_CACHE_DIR");
+        if (env_p) ast_cache_dir = env_p;
+        ast_cache_dir_set = true;
+    }
+    return ast_cache_dir;
+}
+
+bool is_ast_cache_enabled() {
+    return !get_ast_cache_dir().empty();
+}
+
+AST::ast_t* load_ast_cache_entry(Allocator &al, const char *source,
+        size_t size, uint32_t prev_loc) {
+    if (!is_ast_cache_enabled()) return nullptr;
+    std::string s;
+    if (!read_file(get_entry_filename(fnv1a_hash(source, size)), s)) {
+        return nullptr;
+    }
+    // <header>
+    // prev_loc <n>
+    // end
+    // <source>
+    // <serialized AST>
+    std::string header = get_header(size);
+    if (s.compare(0, header.size(), header) != 0) return nullptr;
+    size_t header_end = s.find("\nend\n", header.size());
+    if (header_end == std::string::npos) return nullptr;
+    std::istringstream line(s.substr(header.size(), header_end - header.size()));
+    std::string tag;
+    uint32_t entry_prev_loc;
+    if (!(line >> tag >> entry_prev_loc) || tag != "prev_loc") return nullptr;
+    // The hash only locates the entry, the contents must be the same
+    size_t source_start = header_end + 5;
+    if (s.size() - source_start < size
+            || s.compare(source_start, size, source, size) != 0) {
+        return nullptr;
+    }
+    return deserialize_ast(al, s.substr(source_start + size),
+        prev_loc - entry_prev_loc);
+}
+
+void save_ast_cache_entry(const char *source, size_t size,
+        uint32_t prev_loc, const AST::ast_t &ast) {
+    if (!is_ast_cache_enabled()) return;
+    LargeIntVisitor v;
+    v.visit_ast(ast);
+    if (v.found) return;
+    std::string dir = get_ast_cache_dir();
+    if (!create_directory(dir)) return;
+    std::string filename = get_entry_filename(fnv1a_hash(source, size));
+    // Write to a temporary file first, so that a concurrent compilation
+    // never sees a partially written entry
+    std::string tmp_filename = filename + "." + std::to_string(getpid()) + ".tmp";
+    {
+        std::ofstream out(tmp_filename, std::ofstream::out | std::ofstream::binary);
+        if (!out) return;
+        out << get_header(size) << "prev_loc " << prev_loc << "\nend\n";
+        out.write(source, size);
+        out << serialize_ast(ast);
+        if (!out) {
+            out.close();
+            std::remove(tmp_filename.c_str());
+            return;
+        }
+    }
+    std::remove(filename.c_str());
+    if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+        std::remove(tmp_filename.c_str());
+    }
+}
+
+} // namespace LCompilers::LPython
@@ -0,0 +1,46 @@
+#ifndef LPYTHON_AST_CACHE_H
+#define LPYTHON_AST_CACHE_H
+
+#include <cstdint>
+#include <string>
+
+#include <lpython/python_ast.h>
+
+namespace LCompilers::LPython {
+
+    /*
+        Persistent cache of the AST of source files, so that the files that
+        did not change (e.g. the runtime library modules) are not tokenized
+        and parsed again by the tools that compile the same files over and
+        over (`--show-asr`, `--symtab-only`, the language server).
+
+        An entry is found by the hash of the source contents, so it is found
+        also if the file was moved. It stores the compiler version, the
+        source itself, which must match for the entry to be used (the hash
+        is not collision resistant), the `prev_loc` the file was parsed with
+        and the output of `serialize_ast`. The locations are shifted when the
+        entry is loaded with a different `prev_loc`.
+
+        Only ASTs whose parsing reported no diagnostics (warnings included)
+        are stored, and none with large integer constants, whose values
+        point into the arena of the parser.
+
+        The cache is disabled unless a directory is given, either with
+        `set_ast_cache_dir` (`--ast-cache-dir`) or with the
+        `LPYTHON_AST_CACHE_DIR` environment variable.
+    */
+
+    void set_ast_cache_dir(const std::string &dir);
+    std::string get_ast_cache_dir();
+    bool is_ast_cache_enabled();
+
+    // Returns nullptr if there is no entry for the `size` bytes at `source`
+    AST::ast_t* load_ast_cache_entry(Allocator &al, const char *source,
+        size_t size, uint32_t prev_loc);
+    // Does nothing if `ast` cannot be cached
+    void save_ast_cache_entry(const char *source, size_t size,
+        uint32_t prev_loc, const AST::ast_t &ast);
+
+} // namespace LCompilers::LPython
+
+#endif // LPYTHON_AST_CACHE_H
@@ -0,0 +1,457 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <lpython/bigint.h>
+
+namespace LCompilers::LPython::BigInt {
+
+namespace {
+
+typedef std::vector<uint32_t> Limbs;
+
+// Sign and magnitude, the working representation of the arithmetic
+struct Integer {
+    bool negative = false;
+    // Least significant limb first, no leading zero limbs (0 is empty)
+    Limbs mag;
+};
+
+void trim(Limbs &a) {
+    while (!a.empty() && a.back() == 0) a.pop_back();
+}
+
+Integer to_integer(int64_t i) {
+    Integer r;
+    if (is_int_ptr(i)) {
+        const LargeInt *l = largeint(i);
+        r.negative = l->negative;
+        r.mag.assign(l->limbs, l->limbs + l->n_limbs);
+    } else {
+        r.negative = i < 0;
+        uint64_t m = r.negative ? 0 - (uint64_t)i : (uint64_t)i;
+        while (m != 0) {
+            r.mag.push_back((uint32_t)m);
+            m >>= 32;
+        }
+    }
+    return r;
+}
+
+bool mag_to_uint64(const Limbs &a, uint64_t &m) {
+    if (a.size() > 2) return false;
+    m = 0;
+    for (size_t k = a.size(); k-- > 0;) m = (m << 32) | a[k];
+    return true;
+}
+
+int64_t allocate(Allocator &al, const Integer &x) {
+    LargeInt *l = al.allocate<LargeInt>();
+    l->n_limbs = x.mag.size();
+    l->limbs = al.allocate<uint32_t>(std::max<size_t>(x.mag.size(), 1));
+    std::copy(x.mag.begin(), x.mag.end(), l->limbs);
+    l->negative = x.negative && !x.mag.empty();
+    return ptr_to_int(l);
+}
+
+// Returns a small int if `x` fits, allocates a large int otherwise
+int64_t from_integer(Allocator &al, const Integer &x) {
+    uint64_t m;
+    if (mag_to_uint64(x.mag, m)) {
+        if (!x.negative && m <= (uint64_t)MAX_SMALL_INT) return (int64_t)m;
+        if (x.negative && m <= (1ULL << 63)) return (int64_t)(0 - m);
+    }
+    return allocate(al, x);
+}
+
+int cmp_mag(const Limbs &a, const Limbs &b) {
+    if (a.size() != b.size()) return a.size() < b.size() ? -1 : 1;
+    for (size_t k = a.size(); k-- > 0;) {
+        if (a[k] != b[k]) return a[k] < b[k] ? -1 : 1;
+    }
+    return 0;
+}
+
+Limbs add_mag(const Limbs &a, const Limbs &b) {
+    const Limbs &x = a.size() >= b.size() ? a : b;
+    const Limbs &y = a.size() >= b.size() ? b : a;
+    Limbs r(x.size() + 1);
+    uint64_t carry = 0;
+    for (size_t k = 0; k < x.size(); k++) {
+        uint64_t s = (uint64_t)x[k] + (k < y.size() ? y[k] : 0) + carry;
+        r[k] = (uint32_t)s;
+        carry = s >> 32;
+    }
+    r[x.size()] = (uint32_t)carry;
+    trim(r);
+    return r;
+}
+
+// `a` must not be smaller than `b`
+Limbs sub_mag(const Limbs &a, const Limbs &b) {
+    Limbs r(a.size());
+    int64_t borrow = 0;
+    for (size_t k = 0; k < a.size(); k++) {
+        int64_t d = (int64_t)a[k] - (k < b.size() ? b[k] : 0) - borrow;
+        borrow = d < 0;
+        r[k] = (uint32_t)d;
+    }
+    trim(r);
+    return r;
+}
+
+Limbs mul_mag(const Limbs &a, const Limbs &b) {
+    if (a.empty() || b.empty()) return {};
+    Limbs r(a.size() + b.size());
+    for (size_t i = 0; i < a.size(); i++) {
+        // At most (2^32-1)^2 + 2 (2^32-1) = 2^64-1, no overflow
+        uint64_t carry = 0;
+        for (size_t j = 0; j < b.size(); j++) {
+            uint64_t t = (uint64_t)a[i] * b[j] + r[i+j] + carry;
+            r[i+j] = (uint32_t)t;
+            carry = t >> 32;
+        }
+        r[i+b.size()] = (uint32_t)carry;
+    }
+    trim(r);
+    return r;
+}
+
+// a = a * m + c
+void mul_add_small(Limbs &a, uint32_t m, uint32_t c) {
+    uint64_t carry = c;
+    for (size_t k = 0; k < a.size(); k++) {
+        uint64_t t = (uint64_t)a[k] * m + carry;
+        a[k] = (uint32_t)t;
+        carry = t >> 32;
+    }
+    if (carry != 0) a.push_back((uint32_t)carry);
+}
+
+// a = a / d, returns a % d
+uint32_t divmod_small(Limbs &a, uint32_t d) {
+    uint64_t rem = 0;
+    for (size_t k = a.size(); k-- > 0;) {
+        uint64_t cur = (rem << 32) | a[k];
+        a[k] = (uint32_t)(cur / d);
+        rem = cur % d;
+    }
+    trim(a);
+    return (uint32_t)rem;
+}
+
+Limbs shl_mag(const Limbs &a, uint64_t k) {
+    if (a.empty()) return {};
+    size_t limbs = k / 32;
+    unsigned bits = k % 32;
+    Limbs r(a.size() + limbs + 1);
+    for (size_t i = 0; i < a.size(); i++) {
+        r[i+limbs] |= a[i] << bits;
+        if (bits != 0) r[i+limbs+1] |= a[i] >> (32 - bits);
+    }
+    trim(r);
+    return r;
+}
+
+Limbs shr_mag(const Limbs &a, uint64_t k) {
+    size_t limbs = k / 32;
+    if (limbs >= a.size()) return {};
+    unsigned bits = k % 32;
+    Limbs r(a.size() - limbs);
+    for (size_t i = 0; i < r.size(); i++) {
+        r[i] = a[i+limbs] >> bits;
+        if (bits != 0 && i + limbs + 1 < a.size()) {
+            r[i] |= a[i+limbs+1] << (32 - bits);
+        }
+    }
+    trim(r);
+    return r;
+}
+
+// q = a / b, r = a % b; `b` must not be 0 (Knuth, TAOCP vol. 2, 4.3.1,
+// algorithm D)
+void divmod_mag(const Limbs &a, const Limbs &b, Limbs &q, Limbs &r) {
+    LCOMPILERS_ASSERT(!b.empty());
+    if (cmp_mag(a, b) < 0) {
+        q.clear();
+        r = a;
+        return;
+    }
+    if (b.size() == 1) {
+        q = a;
+        uint32_t rem = divmod_small(q, b[0]);
+        r.clear();
+        if (rem != 0) r.push_back(rem);
+        return;
+    }
+    // Normalize: the most significant bit of the divisor must be set
+    unsigned s = 0;
+    while ((b.back() << s) < 0x80000000u) s++;
+    Limbs v = shl_mag(b, s);
+    Limbs u = shl_mag(a, s);
+    u.resize(a.size() + 1);
+    size_t n = v.size(), m = a.size() - n;
+    q.assign(m + 1, 0);
+    for (size_t j = m + 1; j-- > 0;) {
+        uint64_t num = ((uint64_t)u[j+n] << 32) | u[j+n-1];
+        uint64_t qhat = num / v[n-1];
+        uint64_t rhat = num % v[n-1];
+        while (qhat >= (1ULL << 32)
+                || qhat * v[n-2] > ((rhat << 32) | u[j+n-2])) {
+            qhat--;
+            rhat += v[n-1];
+            if (rhat >= (1ULL << 32)) break;
+        }
+        // u[j:j+n+1] -= qhat * v
+        int64_t borrow = 0;
+        uint64_t carry = 0;
+        for (size_t i = 0; i < n; i++) {
+            uint64_t p = qhat * v[i] + carry;
+            carry = p >> 32;
+            int64_t t = (int64_t)u[i+j] - (int64_t)(p & 0xFFFFFFFFu) - borrow;
+            u[i+j] = (uint32_t)t;
+            borrow = t < 0;
+        }
+        int64_t t = (int64_t)u[j+n] - (int64_t)carry - borrow;
+        u[j+n] = (uint32_t)t;
+        if (t < 0) {
+            // qhat was one too large, add v back
+            qhat--;
+            uint64_t c = 0;
+            for (size_t i = 0; i < n; i++) {
+                uint64_t sum = (uint64_t)u[i+j] + v[i] + c;
+                u[i+j] = (uint32_t)sum;
+                c = sum >> 32;
+            }
+            u[j+n] += (uint32_t)c;
+        }
+        q[j] = (uint32_t)qhat;
+    }
+    trim(q);
+    u.resize(n);
+    trim(u);
+    r = shr_mag(u, s);
+}
+
+Integer add(const Integer &x, const Integer &y) {
+    Integer r;
+    if (x.negative == y.negative) {
+        r.mag = add_mag(x.mag, y.mag);
+        r.negative = x.negative;
+    } else if (cmp_mag(x.mag, y.mag) >= 0) {
+        r.mag = sub_mag(x.mag, y.mag);
+        r.negative = x.negative;
+    } else {
+        r.mag = sub_mag(y.mag, x.mag);
+        r.negative = y.negative;
+    }
+    if (r.mag.empty()) r.negative = false;
+    return r;
+}
+
+Integer negate(Integer x) {
+    x.negative = !x.negative && !x.mag.empty();
+    return x;
+}
+
+Integer mul(const Integer &x, const Integer &y) {
+    Integer r;
+    r.mag = mul_mag(x.mag, y.mag);
+    r.negative = x.negative != y.negative && !r.mag.empty();
+    return r;
+}
+
+// Python's floor division and modulo
+void floor_divmod(const Integer &x, const Integer &y, Integer &q, Integer &r) {
+    divmod_mag(x.mag, y.mag, q.mag, r.mag);
+    q.negative = x.negative != y.negative && !q.mag.empty();
+    r.negative = x.negative && !r.mag.empty();
+    if (!r.mag.empty() && x.negative != y.negative) {
+        q.mag = add_mag(q.mag, {1});
+        q.negative = true;
+        r = add(r, y);
+    }
+}
+
+// Parses the digits in `base`, a chunk of digits at a time
+Integer parse(const char *s, size_t n, int base) {
+    Integer r;
+    uint32_t chunk = 0, mult = 1;
+    for (size_t i = 0; i < n; i++) {
+        char c = s[i];
+        if (c == '_') continue;
+        uint32_t d;
+        if (c >= '0' && c <= '9') {
+            d = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            d = c - 'a' + 10;
+        } else {
+            LCOMPILERS_ASSERT(c >= 'A' && c <= 'F');
+            d = c - 'A' + 10;
+        }
+        LCOMPILERS_ASSERT(d < (uint32_t)base);
+        chunk = chunk * base + d;
+        mult *= base;
+        if (mult > 0xFFFFFFFFu / base) {
+            mul_add_small(r.mag, mult, chunk);
+            chunk = 0;
+            mult = 1;
+        }
+    }
+    if (mult > 1) mul_add_small(r.mag, mult, chunk);
+    trim(r.mag);
+    return r;
+}
+
+std::string to_string(const Integer &x) {
+    if (x.mag.empty()) return "0";
+    // Nine decimal digits at a time
+    std::vector<uint32_t> chunks;
+    Limbs a = x.mag;
+    while (!a.empty()) chunks.push_back(divmod_small(a, 1000000000));
+    std::string s = x.negative ? "-" : "";
+    s += std::to_string(chunks.back());
+    for (size_t k = chunks.size() - 1; k-- > 0;) {
+        std::string digits = std::to_string(chunks[k]);
+        s += std::string(9 - digits.size(), '0') + digits;
+    }
+    return s;
+}
+
+// |i| < 2^61: sums and differences are small ints
+bool is_tiny(int64_t i) {
+    return !is_int_ptr(i) && i > -(1LL << 61) && i < (1LL << 61);
+}
+
+} // namespace
+
+int64_t string_to_largeint(Allocator &al, const Str &s) {
+    return allocate(al, parse(s.p, s.n, 10));
+}
+
+std::string largeint_to_string(int64_t i) {
+    return to_string(to_integer(i));
+}
+
+int64_t parse_int(Allocator &al, const char *s, size_t n, int base) {
+    return from_integer(al, parse(s, n, base));
+}
+
+bool to_int64(int64_t i, int64_t &value) {
+    if (!is_int_ptr(i)) {
+        value = i;
+        return true;
+    }
+    const LargeInt *l = largeint(i);
+    Integer x = to_integer(i);
+    uint64_t m;
+    // Every negative large int is smaller than -2^63
+    if (l->negative || !mag_to_uint64(x.mag, m) || m > (uint64_t)INT64_MAX) {
+        return false;
+    }
+    value = (int64_t)m;
+    return true;
+}
+
+double to_double(int64_t i) {
+    if (!is_int_ptr(i)) return (double)i;
+    Integer x = to_integer(i);
+    size_t n = bit_length(i);
+    uint64_t m;
+    double d;
+    if (n <= 64) {
+        mag_to_uint64(x.mag, m);
+        d = (double)m;
+    } else {
+        // The top 64 bits, the bits below are only needed as a sticky bit
+        // for the rounding of the conversion to 53 bits
+        size_t shift = n - 64;
+        Limbs top = shr_mag(x.mag, shift);
+        mag_to_uint64(top, m);
+        if (shl_mag(top, shift) != x.mag) m |= 1;
+        d = std::ldexp((double)m, (int)std::min<size_t>(shift, 2048));
+    }
+    return x.negative ? -d : d;
+}
+
+size_t bit_length(int64_t i) {
+    Integer x = to_integer(i);
+    if (x.mag.empty()) return 0;
+    size_t n = 32 * (x.mag.size() - 1);
+    for (uint32_t top = x.mag.back(); top != 0; top >>= 1) n++;
+    return n;
+}
+
+int compare(int64_t a, int64_t b) {
+    if (!is_int_ptr(a) && !is_int_ptr(b)) {
+        return a < b ? -1 : (a > b ? 1 : 0);
+    }
+    Integer x = to_integer(a), y = to_integer(b);
+    if (x.negative != y.negative) return x.negative ? -1 : 1;
+    int c = cmp_mag(x.mag, y.mag);
+    return x.negative ? -c : c;
+}
+
+int64_t neg(Allocator &al, int64_t a) {
+    return from_integer(al, negate(to_integer(a)));
+}
+
+int64_t add(Allocator &al, int64_t a, int64_t b) {
+    if (is_tiny(a) && is_tiny(b)) return a + b;
+    return from_integer(al, add(to_integer(a), to_integer(b)));
+}
+
+int64_t sub(Allocator &al, int64_t a, int64_t b) {
+    if (is_tiny(a) && is_tiny(b)) return a - b;
+    return from_integer(al, add(to_integer(a), negate(to_integer(b))));
+}
+
+int64_t mul(Allocator &al, int64_t a, int64_t b) {
+    if (!is_int_ptr(a) && !is_int_ptr(b) && a > INT32_MIN && a <= INT32_MAX
+            && b > INT32_MIN && b <= INT32_MAX) {
+        return a * b;
+    }
+    return from_integer(al, mul(to_integer(a), to_integer(b)));
+}
+
+int64_t floordiv(Allocator &al, int64_t a, int64_t b) {
+    Integer q, r;
+    floor_divmod(to_integer(a), to_integer(b), q, r);
+    return from_integer(al, q);
+}
+
+int64_t mod(Allocator &al, int64_t a, int64_t b) {
+    Integer q, r;
+    floor_divmod(to_integer(a), to_integer(b), q, r);
+    return from_integer(al, r);
+}
+
+int64_t pow(Allocator &al, int64_t a, uint64_t e) {
+    Integer base = to_integer(a), r;
+    r.mag = {1};
+    while (e != 0) {
+        if (e & 1) r = mul(r, base);
+        e >>= 1;
+        if (e != 0) base = mul(base, base);
+    }
+    return from_integer(al, r);
+}
+
+int64_t lshift(Allocator &al, int64_t a, uint64_t k) {
+    Integer x = to_integer(a);
+    x.mag = shl_mag(x.mag, k);
+    return from_integer(al, x);
+}
+
+int64_t rshift(Allocator &al, int64_t a, uint64_t k) {
+    Integer x = to_integer(a);
+    if (x.negative) {
+        // -((|a| - 1) >> k) - 1
+        x.mag = add_mag(shr_mag(sub_mag(x.mag, {1}), k), {1});
+    } else {
+        x.mag = shr_mag(x.mag, k);
+    }
+    return from_integer(al, x);
+}
+
+} // namespace LCompilers::LPython::BigInt
@@ -1,7 +1,8 @@
-#ifndef LFORTRAN_BIGINT_H
-#define LFORTRAN_BIGINT_H
+#ifndef LPYTHON_BIGINT_H
+#define LPYTHON_BIGINT_H
 
 #include <cstdint>
+#include <string>
 
 #include <libasr/containers.h>
 
@@ -71,29 +72,72 @@ inline static bool is_small_int(int64_t i) {
 }
 
 /* Arbitrary integer implementation
- * For now large integers are implemented as strings with decimal digits. The
- * only supported operation on this is converting to and from a string. Later
- * we will replace with an actual large integer implementation and add other
- * operations.
+ *
+ * A large integer is stored in sign and magnitude form. The magnitude is an
+ * array of 32 bit limbs, least significant first, without leading zero
+ * limbs. Both the `LargeInt` and its limbs are allocated with the Allocator
+ * (so they live as long as the AST/ASR that refers to them). The limbs are
+ * never modified after the allocation; the arithmetic below works on
+ * temporary copies and allocates a new `LargeInt` for every large result.
+ *
+ * The arithmetic functions take and return tagged int64_t: results that are
+ * small ints are returned directly, only larger ones are allocated.
  */
 
-// Converts a string to a large int (allocated on heap, returns a pointer)
-inline static int64_t string_to_largeint(Allocator &al, const Str &s) {
-    char *cs = s.c_str(al);
-    return ptr_to_int(cs);
-}
+struct LargeInt {
+    uint32_t *limbs;
+    uint32_t n_limbs;
+    bool negative;
+};
 
-// Converts a large int to a string
-inline static char* largeint_to_string(int64_t i) {
+static_assert(alignof(LargeInt) >= 4);
+
+inline static const LargeInt *largeint(int64_t i) {
     LCOMPILERS_ASSERT(is_int_ptr(i));
-    void *p = int_to_ptr(i);
-    char *cs = (char*)p;
-    return cs;
+    return (const LargeInt *)int_to_ptr(i);
 }
 
+// Converts a string of decimal digits to a large int (allocated with `al`,
+// returns a tagged pointer, even if the value is a small int)
+int64_t string_to_largeint(Allocator &al, const Str &s);
+
+// Converts a large int to a string of decimal digits
+std::string largeint_to_string(int64_t i);
+
+// Parses the digits `s[0:n]` in `base` (2, 8, 10 or 16), underscores are
+// skipped. Returns a small int if the value fits, a large int otherwise.
+int64_t parse_int(Allocator &al, const char *s, size_t n, int base);
+
+// Returns true and sets `value` if `i` fits into int64_t (a large int can
+// be in the int64_t range: 2^62 .. 2^63-1)
+bool to_int64(int64_t i, int64_t &value);
+
+// The nearest double to `i` (infinity if it is out of range)
+double to_double(int64_t i);
+
+// The number of bits of |i|
+size_t bit_length(int64_t i);
+
+// -1, 0 or 1 if a < b, a == b or a > b
+int compare(int64_t a, int64_t b);
+
+int64_t neg(Allocator &al, int64_t a);
+int64_t add(Allocator &al, int64_t a, int64_t b);
+int64_t sub(Allocator &al, int64_t a, int64_t b);
+int64_t mul(Allocator &al, int64_t a, int64_t b);
+// Python's `//` and `%`: the quotient is rounded towards -infinity and the
+// remainder has the sign of `b`. `b` must not be 0.
+int64_t floordiv(Allocator &al, int64_t a, int64_t b);
+int64_t mod(Allocator &al, int64_t a, int64_t b);
+// `e` must not be negative
+int64_t pow(Allocator &al, int64_t a, uint64_t e);
+// Python's `<<` and `>>` (rounds towards -infinity)
+int64_t lshift(Allocator &al, int64_t a, uint64_t k);
+int64_t rshift(Allocator &al, int64_t a, uint64_t k);
+
 inline static std::string int_to_str(int64_t i) {
     if (is_int_ptr(i)) {
-        return std::string(largeint_to_string(i));
+        return largeint_to_string(i);
     } else {
         return std::to_string(i);
     }
@@ -140,6 +184,10 @@ struct BigInt {
         n = string_to_largeint(al, s);
     }
 
+    void from_string(Allocator &al, const char *s, size_t len, int base) {
+        n = parse_int(al, s, len, base);
+    }
+
     bool is_large() const {
         return is_int_ptr(n);
     }
@@ -165,4 +213,4 @@ static_assert(sizeof(BigInt) == 8);
 
 } // LCompilers::LPython
 
-#endif // LFORTRAN_BIGINT_H
+#endif // LPYTHON_BIGINT_H
@@ -0,0 +1,339 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+
+#include <libasr/codegen/evaluator.h>
+#include <libasr/config.h>
+#include <libasr/string_utils.h>
+#include <lpython/asr_cache.h>
+#include <lpython/incremental.h>
+#include <lpython/utils.h>
+
+namespace LCompilers::LPython {
+
+namespace {
+
+    const std::string manifest_magic = "LPython incremental build";
+
+    struct ManifestModule {
+        uint64_t hash = 0;    // Hash of the source
+        uint64_t symbols = 0; // Hash of the names of the symbols it defines
+        std::map<std::string, uint64_t> dependencies;
+    };
+
+    struct Manifest {
+        uint64_t options = 0;
+        std::map<std::string, ManifestModule> modules;
+        // Hashes of the source and of the object file of the main program,
+        // 0 if the build cannot be checked before parsing
+        uint64_t program = 0;
+        uint64_t program_object = 0;
+        // Every imported source file, with its hash
+        std::map<std::string, uint64_t> sources;
+    };
+
+    // LPython incremental build <version>
+    // options <hash>
+    // module <name> <hash> <symbols hash>
+    // dep <name> <hash> (for each module it imports)
+    // ...
+    // program <source hash> <object hash>
+    // source <hash> <path> (for each imported source file)
+    // ...
+    // end
+    bool read_manifest(const std::string &filename, Manifest &manifest) {
+        std::string s;
+        if (!read_file(filename, s)) return false;
+        std::istringstream in(s);
+        std::string line;
+        if (!std::getline(in, line) || line != manifest_magic + " " + LFORTRAN_VERSION) {
+            return false;
+        }
+        ManifestModule *module = nullptr;
+        while (std::getline(in, line)) {
+            std::istringstream l(line);
+            std::string tag, name, hash, symbols;
+            l >> tag;
+            if (tag == "options" && l >> hash) {
+                manifest.options = std::strtoull(hash.c_str(), nullptr, 16);
+            } else if (tag == "module" && l >> name >> hash >> symbols) {
+                module = &manifest.modules[name];
+                module->hash = std::strtoull(hash.c_str(), nullptr, 16);
+                module->symbols = std::strtoull(symbols.c_str(), nullptr, 16);
+            } else if (tag == "dep" && module && l >> name >> hash) {
+                module->dependencies[name] = std::strtoull(hash.c_str(), nullptr, 16);
+            } else if (tag == "program" && l >> hash >> symbols) {
+                manifest.program = std::strtoull(hash.c_str(), nullptr, 16);
+                manifest.program_object = std::strtoull(symbols.c_str(), nullptr, 16);
+            } else if (tag == "source" && l >> hash && std::getline(l, name)
+                    && name.size() > 1) {
+                // The path is the rest of the line, it may contain spaces
+                manifest.sources[name.substr(1)] = std::strtoull(hash.c_str(), nullptr, 16);
+            } else if (tag == "end") {
+                return true;
+            } else {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    bool write_manifest(const std::string &filename, const Manifest &manifest) {
+        std::ofstream out(filename, std::ofstream::out | std::ofstream::binary);
+        if (!out) return false;
+        out << manifest_magic << " " << LFORTRAN_VERSION << "\n";
+        out << "options " << hash_to_hex(manifest.options) << "\n";
+        for (auto &module: manifest.modules) {
+            out << "module " << module.first << " "
+                << hash_to_hex(module.second.hash) << " "
+                << hash_to_hex(module.second.symbols) << "\n";
+            for (auto &dep: module.second.dependencies) {
+                out << "dep " << dep.first << " " << hash_to_hex(dep.second) << "\n";
+            }
+        }
+        if (manifest.program != 0) {
+            out << "program " << hash_to_hex(manifest.program) << " "
+                << hash_to_hex(manifest.program_object) << "\n";
+            for (auto &source: manifest.sources) {
+                out << "source " << hash_to_hex(source.second) << " "
+                    << source.first << "\n";
+            }
+        }
+        out << "end\n";
+        return (bool)out;
+    }
+
+    // Values that can be defined in several object files
+    bool is_mergeable(const llvm::GlobalValue &gv) {
+        return gv.hasLocalLinkage() || gv.hasLinkOnceLinkage()
+            || gv.hasWeakLinkage() || gv.hasAvailableExternallyLinkage();
+    }
+
+    // The partition of a value is the module that owns it, "" is the main
+    // program. Mergeable values go to every partition that uses them.
+    typedef std::map<const llvm::GlobalValue*, std::set<std::string>> Partitions;
+
+    void collect_user_partitions(const llvm::Value *v,
+            Partitions &partitions, std::set<std::string> &parts) {
+        for (const llvm::User *u: v->users()) {
+            const llvm::GlobalValue *gv = nullptr;
+            if (auto inst = llvm::dyn_cast<llvm::Instruction>(u)) {
+                gv = inst->getFunction();
+            } else {
+                gv = llvm::dyn_cast<llvm::GlobalValue>(u);
+            }
+            if (gv) {
+                auto &user_parts = partitions[gv];
+                parts.insert(user_parts.begin(), user_parts.end());
+            } else {
+                // Constant expressions and aggregates
+                collect_user_partitions(u, partitions, parts);
+            }
+        }
+    }
+
+    // Hash of the contents of `filename`, 0 if it cannot be read
+    uint64_t hash_file(const std::string &filename) {
+        std::string s;
+        if (!read_file(filename, s)) return 0;
+        return fnv1a_hash(s);
+    }
+
+} // namespace
+
+uint64_t get_incremental_options_hash(const CompilerOptions &compiler_options,
+        const CodegenOptions &codegen_options) {
+    std::string s = compiler_options.target
+        + " " + std::to_string((int)compiler_options.platform)
+        + " " + std::to_string(compiler_options.po.fast)
+        + std::to_string(compiler_options.bounds_checking)
+        + std::to_string(compiler_options.openmp)
+        + std::to_string(compiler_options.emit_debug_info)
+        + std::to_string(compiler_options.enable_symengine)
+        + std::to_string(compiler_options.po.enable_cpython)
+        + std::to_string(codegen_options.profile_generate);
+    // The files can change without their names changing
+    if (!codegen_options.runtime_bitcode.empty()) {
+        s += " runtime " + hash_to_hex(hash_file(codegen_options.runtime_bitcode));
+    }
+    if (!codegen_options.profile_use.empty()) {
+        s += " profile " + hash_to_hex(hash_file(codegen_options.profile_use));
+    }
+    for (auto &isa: codegen_options.multiversion) {
+        s += " isa " + isa;
+    }
+    return fnv1a_hash(s, fnv1a_hash(LFORTRAN_VERSION));
+}
+
+bool is_incremental_build_up_to_date(const std::string &infile,
+        const std::string &outfile, const std::string &build_dir,
+        uint64_t options_hash, std::vector<std::string> &objects) {
+    Manifest manifest;
+    if (!read_manifest(build_dir + "/manifest", manifest)
+            || manifest.options != options_hash || manifest.program == 0
+            || hash_file(infile) != manifest.program
+            || hash_file(outfile) != manifest.program_object) {
+        return false;
+    }
+    for (auto &source: manifest.sources) {
+        if (hash_file(source.first) != source.second) return false;
+    }
+    std::vector<std::string> module_objects;
+    for (auto &module: manifest.modules) {
+        std::string object = build_dir + "/" + module.first + ".o";
+        if (!path_exists(object)) return false;
+        module_objects.push_back(object);
+    }
+    objects.insert(objects.end(), module_objects.begin(), module_objects.end());
+    return true;
+}
+
+bool save_incremental_object_files(ASR::TranslationUnit_t &asr,
+        llvm::Module &m, LLVMEvaluator &e, const std::string &infile,
+        const std::string &outfile, const std::string &build_dir,
+        uint64_t options_hash, std::vector<std::string> &objects) {
+    std::string manifest_filename = build_dir + "/manifest";
+    // Only the modules compiled from a file that can be checked for changes
+    // get their own object
+    Manifest manifest;
+    manifest.options = options_hash;
+    // The whole build can only be checked before parsing if every imported
+    // module is backed by a file
+    bool checkable = true;
+    std::vector<std::string> module_names;
+    std::map<std::string, std::string> variables;
+    for (auto &item: asr.m_symtab->get_scope()) {
+        if (!ASR::is_a<ASR::Module_t>(*item.second)) continue;
+        ASRCacheModule module;
+        std::vector<std::string> dependencies;
+        std::vector<ASRCacheModule> imported;
+        if (!get_asr_cache_module(item.first, module, dependencies)
+                || !collect_asr_cache_dependencies(item.first, dependencies,
+                    imported)) {
+            checkable = false;
+            continue;
+        }
+        ManifestModule &mm = manifest.modules[item.first];
+        mm.hash = module.hash;
+        manifest.sources[module.path] = module.hash;
+        for (auto &dep: imported) {
+            mm.dependencies[dep.name] = dep.hash;
+            manifest.sources[dep.path] = dep.hash;
+        }
+        module_names.push_back(item.first);
+        ASR::Module_t *mod = ASR::down_cast<ASR::Module_t>(item.second);
+        for (auto &sym: mod->m_symtab->get_scope()) {
+            if (ASR::is_a<ASR::Variable_t>(*sym.second)) {
+                // A name used by several modules is left to the main program
+                auto it = variables.find(sym.first);
+                variables[sym.first] = (it == variables.end()) ? item.first : "";
+            }
+        }
+    }
+    // Longest first, so that `__module_a_b_f` goes to `a_b` rather than `a`
+    std::sort(module_names.begin(), module_names.end(),
+        [](const std::string &a, const std::string &b) {
+            return a.size() > b.size();
+        });
+    auto get_owner = [&](const std::string &name) -> std::string {
+        for (auto &module_name: module_names) {
+            if (startswith(name, "__module_" + module_name + "_")) {
+                return module_name;
+            }
+        }
+        auto it = variables.find(name);
+        return it != variables.end() ? it->second : "";
+    };
+
+    Partitions partitions;
+    std::map<std::string, std::set<std::string>> symbols;
+    for (auto &gv: m.global_values()) {
+        if (gv.isDeclaration() || is_mergeable(gv)) continue;
+        std::string owner = get_owner(gv.getName().str());
+        partitions[&gv] = {owner};
+        symbols[owner].insert(gv.getName().str());
+    }
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto &gv: m.global_values()) {
+            if (gv.isDeclaration() || !is_mergeable(gv)) continue;
+            std::set<std::string> parts;
+            collect_user_partitions(&gv, partitions, parts);
+            auto &gv_parts = partitions[&gv];
+            size_t n = gv_parts.size();
+            gv_parts.insert(parts.begin(), parts.end());
+            if (gv_parts.size() != n) changed = true;
+        }
+    }
+    for (auto &gv: m.global_values()) {
+        if (gv.isDeclaration() || !is_mergeable(gv)) continue;
+        auto &gv_parts = partitions[&gv];
+        if (gv_parts.empty()) gv_parts.insert("");
+        // Internal state cannot be duplicated
+        auto var = llvm::dyn_cast<llvm::GlobalVariable>(&gv);
+        if (var && var->hasLocalLinkage() && !var->isConstant()
+                && gv_parts.size() > 1) {
+            // The caller writes a single object file, the previous build
+            // must not be taken as up to date
+            std::remove(manifest_filename.c_str());
+            return false;
+        }
+    }
+
+    if (!create_directory(build_dir)) return false;
+    Manifest old;
+    bool have_old = read_manifest(manifest_filename, old)
+        && old.options == options_hash;
+    auto save_partition = [&](const std::string &partition,
+            const std::string &filename) {
+        llvm::ValueToValueMapTy vmap;
+        std::unique_ptr<llvm::Module> part = llvm::CloneModule(m, vmap,
+            [&](const llvm::GlobalValue *gv) {
+                auto it = partitions.find(gv);
+                return it != partitions.end() && it->second.count(partition) > 0;
+            });
+        e.save_object_file(*part, filename);
+    };
+    for (auto &module_name: module_names) {
+        ManifestModule &mm = manifest.modules[module_name];
+        std::string names;
+        for (auto &name: symbols[module_name]) {
+            names += name + "\n";
+        }
+        mm.symbols = fnv1a_hash(names);
+        if (symbols[module_name].empty()) {
+            // Nothing to link (e.g. all its functions were unused)
+            manifest.modules.erase(module_name);
+            continue;
+        }
+        std::string object = build_dir + "/" + module_name + ".o";
+        auto it = old.modules.find(module_name);
+        bool up_to_date = have_old && it != old.modules.end()
+            && it->second.hash == mm.hash
+            && it->second.symbols == mm.symbols
+            && it->second.dependencies == mm.dependencies
+            && path_exists(object);
+        if (!up_to_date) {
+            save_partition(module_name, object);
+        }
+        objects.push_back(object);
+    }
+    save_partition("", outfile);
+    if (checkable) {
+        manifest.program = hash_file(infile);
+        manifest.program_object = hash_file(outfile);
+    }
+    write_manifest(manifest_filename, manifest);
+    return true;
+}
+
+} // namespace LCompilers::LPython
@@ -0,0 +1,84 @@
+#ifndef LPYTHON_INCREMENTAL_H
+#define LPYTHON_INCREMENTAL_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <libasr/asr.h>
+#include <libasr/utils.h>
+
+namespace llvm {
+    class Module;
+}
+
+namespace LCompilers {
+    class LLVMEvaluator;
+}
+
+namespace LCompilers::LPython {
+
+    /*
+        Incremental builds (`--incremental`).
+
+        The LLVM module of a program is split into one object file per
+        imported module (asr_to_llvm names the functions of a module `M`
+        `__module_M_...`) and the object file of the main program, which also
+        gets everything that cannot be attributed to a module.
+
+        The objects of the modules are kept in a build directory together
+        with a manifest that records, for each of them, the hash of its
+        source, the hashes of all the modules it (transitively) imports, as
+        given by the import graph of the ASR cache, and the symbols it
+        defines. On a rebuild only the modules whose source or any of whose
+        imports changed are code generated again.
+
+        The manifest also records the hashes of the main program, of its
+        object file and of every imported source file: if none of them
+        changed, the previous build is used as is, before parsing.
+    */
+
+    // The options of PythonCompiler (see lpython/python_evaluator.h) that
+    // affect the generated code but are not part of CompilerOptions
+    struct CodegenOptions {
+        std::string runtime_bitcode;
+        bool profile_generate = false;
+        std::string profile_use;
+        std::vector<std::string> multiversion;
+    };
+
+    // Hash of the options that affect the generated code, including the
+    // contents of the profile and of the runtime bitcode
+    uint64_t get_incremental_options_hash(const CompilerOptions &compiler_options,
+        const CodegenOptions &codegen_options);
+
+    /*
+        Returns true if the previous build of `infile` to `outfile` is up to
+        date: the options, `infile`, `outfile` and every source file it
+        imports are unchanged, and all the module objects exist. `objects` is
+        then extended with the module objects that must be linked together
+        with `outfile`. Only hashes files, so it is done before parsing.
+    */
+    bool is_incremental_build_up_to_date(const std::string &infile,
+        const std::string &outfile, const std::string &build_dir,
+        uint64_t options_hash, std::vector<std::string> &objects);
+
+    /*
+        Writes the object file of the main program `infile` to `outfile` and
+        those of the imported modules to `build_dir`, reusing the ones that
+        are up to date. `objects` is set to the module objects that must be
+        linked together with `outfile`.
+
+        Returns false without writing any object file if the module cannot
+        be split (e.g. if two modules share internal mutable state), the
+        caller should then emit a single object file as usual. The manifest
+        of the previous build is removed then.
+    */
+    bool save_incremental_object_files(ASR::TranslationUnit_t &asr,
+        llvm::Module &m, LLVMEvaluator &e, const std::string &infile,
+        const std::string &outfile, const std::string &build_dir,
+        uint64_t options_hash, std::vector<std::string> &objects);
+
+} // namespace LCompilers::LPython
+
+#endif // LPYTHON_INCREMENTAL_H
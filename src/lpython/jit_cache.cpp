@@ -0,0 +1,177 @@
+#include <cstdio>
+#include <fstream>
+#include <map>
+
+#ifdef _WIN32
+    #include <process.h>
+    #define getpid _getpid
+#else
+    #include <unistd.h>
+#endif
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#include <llvm/ExecutionEngine/Orc/CompileUtils.h>
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/IR/Module.h>
+#if LLVM_VERSION_MAJOR >= 17
+#include <llvm/TargetParser/Host.h>
+#else
+#include <llvm/Support/Host.h>
+#endif
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <libasr/config.h>
+#include <lpython/jit_cache.h>
+#include <lpython/utils.h>
+
+namespace LCompilers::LPython {
+
+namespace {
+
+    class JITObjectCache : public llvm::ObjectCache {
+    public:
+        JITObjectCache(const std::string &cache_dir, uint64_t options_hash)
+            : cache_dir{cache_dir}, options_hash{options_hash} {}
+
+        size_t hits = 0;
+
+        void notifyObjectCompiled(const llvm::Module *m,
+                llvm::MemoryBufferRef obj) override {
+            if (!create_directory(cache_dir)) return;
+            std::string filename = get_filename(m);
+            // Write to a temporary file first, so that a concurrent run never
+            // loads a partially written object
+            std::string tmp_filename = filename + "." + std::to_string(getpid()) + ".tmp";
+            {
+                std::ofstream out(tmp_filename, std::ofstream::out | std::ofstream::binary);
+                if (!out) return;
+                out.write(obj.getBufferStart(), obj.getBufferSize());
+                if (!out) {
+                    out.close();
+                    std::remove(tmp_filename.c_str());
+                    return;
+                }
+            }
+            if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+                std::remove(tmp_filename.c_str());
+            }
+        }
+
+        std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *m) override {
+            auto buffer = llvm::MemoryBuffer::getFile(get_filename(m));
+            if (!buffer) return nullptr;
+            hits++;
+            return std::move(*buffer);
+        }
+
+    private:
+        std::string cache_dir;
+        uint64_t options_hash;
+        // Printing the IR is not free, it is only done once per module
+        std::map<const llvm::Module*, std::string> filenames;
+
+        std::string get_filename(const llvm::Module *m) {
+            auto it = filenames.find(m);
+            if (it != filenames.end()) return it->second;
+            std::string ir;
+            llvm::raw_string_ostream os(ir);
+            m->print(os, nullptr);
+            uint64_t h = fnv1a_hash(LFORTRAN_VERSION " " LLVM_VERSION_STRING " ");
+            h = fnv1a_hash(m->getTargetTriple() + " "
+                + llvm::sys::getHostCPUName().str() + " "
+                + hash_to_hex(options_hash) + "\n", h);
+            h = fnv1a_hash(os.str(), h);
+            std::string filename = cache_dir + "/" + hash_to_hex(h) + ".o";
+            filenames[m] = filename;
+            return filename;
+        }
+    };
+
+} // namespace
+
+struct CachingJIT::Impl {
+    std::unique_ptr<JITObjectCache> cache;
+    std::unique_ptr<llvm::orc::LLJIT> jit;
+};
+
+CachingJIT::CachingJIT() : impl{std::make_unique<Impl>()} {}
+
+CachingJIT::~CachingJIT() = default;
+
+std::unique_ptr<CachingJIT> CachingJIT::create(const std::string &cache_dir,
+        uint64_t options_hash, std::string &error) {
+    std::unique_ptr<CachingJIT> r(new CachingJIT());
+    r->impl->cache = std::make_unique<JITObjectCache>(cache_dir, options_hash);
+    JITObjectCache *cache = r->impl->cache.get();
+    auto jit = llvm::orc::LLJITBuilder()
+        .setCompileFunctionCreator([cache](llvm::orc::JITTargetMachineBuilder jtmb)
+                -> llvm::Expected<std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
+            auto tm = jtmb.createTargetMachine();
+            if (!tm) return tm.takeError();
+            return std::make_unique<llvm::orc::TMOwningSimpleCompiler>(
+                std::move(*tm), cache);
+        })
+        .create();
+    if (!jit) {
+        error = llvm::toString(jit.takeError());
+        return nullptr;
+    }
+    r->impl->jit = std::move(*jit);
+    // Resolve the runtime library (and everything else) from the process,
+    // as LLVMEvaluator does
+    auto generator = llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+        r->impl->jit->getDataLayout().getGlobalPrefix());
+    if (!generator) {
+        error = llvm::toString(generator.takeError());
+        return nullptr;
+    }
+    r->impl->jit->getMainJITDylib().addGenerator(std::move(*generator));
+    return r;
+}
+
+bool CachingJIT::add_module(const llvm::Module &m, std::string &error) {
+    // The JIT owns the context of its modules, copy `m` into a new one
+    llvm::SmallVector<char, 0> bitcode;
+    llvm::raw_svector_ostream os(bitcode);
+    llvm::WriteBitcodeToFile(m, os);
+    auto context = std::make_unique<llvm::LLVMContext>();
+    auto copy = llvm::parseBitcodeFile(llvm::MemoryBufferRef(
+        llvm::StringRef(bitcode.data(), bitcode.size()), m.getName()), *context);
+    if (!copy) {
+        error = llvm::toString(copy.takeError());
+        return false;
+    }
+    (*copy)->setDataLayout(impl->jit->getDataLayout());
+    llvm::Error err = impl->jit->addIRModule(llvm::orc::ThreadSafeModule(
+        std::move(*copy), std::move(context)));
+    if (err) {
+        error = llvm::toString(std::move(err));
+        return false;
+    }
+    return true;
+}
+
+intptr_t CachingJIT::get_symbol_address(const std::string &name) {
+    auto symbol = impl->jit->lookup(name);
+    if (!symbol) {
+        llvm::consumeError(symbol.takeError());
+        return 0;
+    }
+#if LLVM_VERSION_MAJOR >= 15
+    return (intptr_t)symbol->getValue();
+#else
+    return (intptr_t)symbol->getAddress();
+#endif
+}
+
+size_t CachingJIT::cache_hits() const {
+    return impl->cache->hits;
+}
+
+} // namespace LCompilers::LPython
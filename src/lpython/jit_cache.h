@@ -0,0 +1,48 @@
+#ifndef LPYTHON_JIT_CACHE_H
+#define LPYTHON_JIT_CACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace llvm {
+    class Module;
+}
+
+namespace LCompilers::LPython {
+
+    /*
+        An ORC JIT with a persistent object cache, used by `--jit` when a
+        cache directory is given (`--jit-cache-dir` or the
+        `LPYTHON_JIT_CACHE_DIR` environment variable).
+
+        The machine code of every module is stored in the cache directory,
+        keyed by the hash of the (already optimized) LLVM IR, the host
+        target and `options_hash`. Running an unchanged program again loads
+        the object file instead of running the code generator.
+    */
+    class CachingJIT {
+    public:
+        // Returns nullptr (and sets `error`) if the JIT cannot be created
+        static std::unique_ptr<CachingJIT> create(const std::string &cache_dir,
+            uint64_t options_hash, std::string &error);
+        ~CachingJIT();
+
+        // Adds a copy of `m`, which can be in any LLVMContext
+        bool add_module(const llvm::Module &m, std::string &error);
+        // Returns 0 if `name` is not defined
+        intptr_t get_symbol_address(const std::string &name);
+
+        // Number of modules whose object was found in the cache
+        size_t cache_hits() const;
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> impl;
+
+        CachingJIT();
+    };
+
+} // namespace LCompilers::LPython
+
+#endif // LPYTHON_JIT_CACHE_H
@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <cstdlib>
+#include <dirent.h>
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/raw_ostream.h>
+#include <lld/Common/Driver.h>
+#if LLVM_VERSION_MAJOR >= 14
+#include <lld/Common/CommonLinkerContext.h>
+#endif
+
+#include <lpython/lld_link.h>
+#include <lpython/utils.h>
+#include <libasr/string_utils.h>
+
+#if LLVM_VERSION_MAJOR >= 17
+LLD_HAS_DRIVER(elf)
+#endif
+
+namespace LCompilers::LPython {
+
+namespace {
+
+    std::string find_file(const std::vector<std::string> &dirs,
+            const std::string &name) {
+        for (auto &dir: dirs) {
+            if (path_exists(dir + "/" + name)) return dir + "/" + name;
+        }
+        return "";
+    }
+
+    // Compares GCC version directory names such as "7", "11" or "4.8.5"
+    bool version_less(const std::string &a, const std::string &b) {
+        size_t i = 0, j = 0;
+        while (i < a.size() || j < b.size()) {
+            long x = std::strtol(a.c_str() + i, nullptr, 10);
+            long y = std::strtol(b.c_str() + j, nullptr, 10);
+            if (x != y) return x < y;
+            i = a.find('.', i);
+            j = b.find('.', j);
+            if (i == std::string::npos || j == std::string::npos) {
+                return i != std::string::npos ? false : j != std::string::npos;
+            }
+            i++; j++;
+        }
+        return false;
+    }
+
+    // The directory with crtbegin.o, libgcc.a, ... of the newest GCC
+    std::string find_gcc_dir(const std::vector<std::string> &gcc_roots) {
+        for (auto &root: gcc_roots) {
+            DIR *dir = opendir(root.c_str());
+            if (!dir) continue;
+            std::vector<std::string> versions;
+            while (struct dirent *entry = readdir(dir)) {
+                std::string name = entry->d_name;
+                if (!name.empty() && name[0] >= '0' && name[0] <= '9'
+                        && path_exists(root + "/" + name + "/crtbegin.o")) {
+                    versions.push_back(name);
+                }
+            }
+            closedir(dir);
+            if (!versions.empty()) {
+                std::sort(versions.begin(), versions.end(), version_less);
+                return root + "/" + versions.back();
+            }
+        }
+        return "";
+    }
+
+} // namespace
+
+bool lld_link_executable(const std::vector<std::string> &infiles,
+        const std::string &outfile, const std::string &runtime_library_dir,
+        const std::string &target_triple, bool static_executable,
+        std::string &error) {
+    std::string arch = target_triple.substr(0, target_triple.find('-'));
+    std::string dynamic_linker;
+    if (arch == "x86_64") {
+        dynamic_linker = "/lib64/ld-linux-x86-64.so.2";
+    } else if (arch == "aarch64") {
+        dynamic_linker = "/lib/ld-linux-aarch64.so.1";
+    }
+    if (dynamic_linker.empty() || target_triple.find("linux") == std::string::npos) {
+        error = "in-process linking is not supported for " + target_triple;
+        return false;
+    }
+
+    std::string multiarch = arch + "-linux-gnu";
+    std::vector<std::string> lib_dirs = {"/usr/lib/" + multiarch,
+        "/lib/" + multiarch, "/usr/lib64", "/lib64", "/usr/lib", "/lib"};
+    std::string gcc_dir = find_gcc_dir({"/usr/lib/gcc/" + multiarch,
+        "/usr/lib/gcc/" + arch + "-redhat-linux",
+        "/usr/lib64/gcc/" + arch + "-suse-linux",
+        "/usr/lib/gcc/" + arch + "-pc-linux-gnu"});
+    std::string runtime_lib = runtime_library_dir + "/liblpython_runtime_static.a";
+    std::string crt1 = find_file(lib_dirs, "crt1.o");
+    std::string crti = find_file(lib_dirs, "crti.o");
+    std::string crtn = find_file(lib_dirs, "crtn.o");
+    std::string crtbegin = gcc_dir + (static_executable ? "/crtbeginT.o" : "/crtbegin.o");
+    std::string crtend = gcc_dir + "/crtend.o";
+    if (gcc_dir.empty() || crt1.empty() || crti.empty() || crtn.empty()
+            || !path_exists(crtbegin) || !path_exists(runtime_lib)
+            || (!static_executable && !path_exists(dynamic_linker))) {
+        error = "the C runtime files or the LPython runtime library were not found";
+        return false;
+    }
+
+    // The same command line `cc` passes to `ld` (non-PIE)
+    std::vector<std::string> args = {"ld.lld", "--eh-frame-hdr", "-o", outfile};
+    if (static_executable) {
+        args.push_back("-static");
+    } else {
+        args.insert(args.end(), {"-dynamic-linker", dynamic_linker});
+    }
+    args.insert(args.end(), {crt1, crti, crtbegin, "-L" + gcc_dir});
+    for (auto &dir: lib_dirs) {
+        if (is_directory(dir)) args.push_back("-L" + dir);
+    }
+    args.insert(args.end(), infiles.begin(), infiles.end());
+    args.insert(args.end(), {runtime_lib, "-lm"});
+    if (static_executable) {
+        args.insert(args.end(), {"--start-group", "-lgcc", "-lgcc_eh", "-lc",
+            "--end-group"});
+    } else {
+        args.insert(args.end(), {"-lgcc", "--as-needed", "-lgcc_s",
+            "--no-as-needed", "-lc", "-lgcc", "--as-needed", "-lgcc_s",
+            "--no-as-needed"});
+    }
+    args.insert(args.end(), {crtend, crtn});
+
+    std::vector<const char*> argv;
+    for (auto &arg: args) {
+        argv.push_back(arg.c_str());
+    }
+    std::string out_str, err_str;
+    llvm::raw_string_ostream out_os(out_str), err_os(err_str);
+#if LLVM_VERSION_MAJOR >= 14
+    bool ok = lld::elf::link(argv, out_os, err_os, /*exitEarly=*/false,
+        /*disableOutput=*/false);
+    lld::CommonLinkerContext::destroy();
+#else
+    bool ok = lld::elf::link(argv, /*canExitEarly=*/false, out_os, err_os);
+#endif
+    if (!ok) {
+        error = "ld.lld failed:\n" + err_os.str();
+    }
+    return ok;
+}
+
+} // namespace LCompilers::LPython
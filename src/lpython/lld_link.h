@@ -0,0 +1,27 @@
+#ifndef LPYTHON_LLD_LINK_H
+#define LPYTHON_LLD_LINK_H
+
+#include <string>
+#include <vector>
+
+namespace LCompilers::LPython {
+
+    /*
+        Links the ELF object files `infiles` with the static runtime library
+        into the executable `outfile` by calling LLD in-process, i.e.,
+        without spawning `cc`.
+
+        The C runtime startup files, libc and libgcc are located the same
+        way `cc` would find them on common Linux distributions. Returns false
+        if that fails or if the target is not supported, in which case the
+        caller should fall back to linking with `cc`; `error` then contains
+        the reason (and the LLD diagnostics, if any).
+    */
+    bool lld_link_executable(const std::vector<std::string> &infiles,
+        const std::string &outfile, const std::string &runtime_library_dir,
+        const std::string &target_triple, bool static_executable,
+        std::string &error);
+
+} // namespace LCompilers::LPython
+
+#endif // LPYTHON_LLD_LINK_H
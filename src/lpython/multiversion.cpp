@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <map>
+
+#include <llvm/Config/llvm-config.h>
+#if LLVM_VERSION_MAJOR >= 17
+#include <llvm/TargetParser/Triple.h>
+#else
+#include <llvm/ADT/Triple.h>
+#endif
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/IR/Dominators.h>
+#include <llvm/IR/GlobalIFunc.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+
+#include <lpython/multiversion.h>
+
+namespace LCompilers::LPython {
+
+namespace {
+
+    // Bits of `__cpu_model.__cpu_features[0]` (`enum processor_features` in
+    // libgcc's cpuinfo.h, shared by compiler-rt)
+    const uint32_t feature_avx = 1u << 9;
+    const uint32_t feature_avx2 = 1u << 10;
+    const uint32_t feature_fma = 1u << 14;
+    const uint32_t feature_avx512f = 1u << 15;
+    const uint32_t feature_avx512vl = 1u << 20;
+    const uint32_t feature_avx512bw = 1u << 21;
+    const uint32_t feature_avx512dq = 1u << 22;
+
+    struct ISALevel {
+        std::string name;
+        std::string target_features; // Of the clones
+        uint32_t cpu_features;       // Required at run time
+    };
+
+    // From the least to the most capable
+    const std::vector<ISALevel> isa_levels = {
+        {"avx2", "+avx,+avx2,+fma",
+            feature_avx | feature_avx2 | feature_fma},
+        {"avx512", "+avx,+avx2,+fma,+avx512f,+avx512vl,+avx512bw,+avx512dq",
+            feature_avx | feature_avx2 | feature_fma | feature_avx512f
+            | feature_avx512vl | feature_avx512bw | feature_avx512dq},
+    };
+
+    // Functions with a loop that indexes memory, i.e., loops over arrays
+    bool has_array_loop(llvm::Function &f) {
+        llvm::DominatorTree dt(f);
+        llvm::LoopInfo li(dt);
+        for (llvm::Loop *loop: li.getLoopsInPreorder()) {
+            for (llvm::BasicBlock *bb: loop->blocks()) {
+                for (llvm::Instruction &inst: *bb) {
+                    auto gep = llvm::dyn_cast<llvm::GetElementPtrInst>(&inst);
+                    if (gep && !gep->hasAllConstantIndices()) return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Returns the clone of `f` for the best level the CPU supports
+    void create_resolver(llvm::Module &m, llvm::Function *resolver,
+            llvm::Function *f, const std::vector<llvm::Function*> &clones,
+            const std::vector<const ISALevel*> &levels) {
+        llvm::LLVMContext &context = m.getContext();
+        llvm::Type *i32 = llvm::Type::getInt32Ty(context);
+        // struct __processor_model { unsigned int __cpu_vendor, __cpu_type,
+        //     __cpu_subtype, __cpu_features[1]; }
+        llvm::StructType *cpu_model_type = llvm::StructType::get(context,
+            {i32, i32, i32, llvm::ArrayType::get(i32, 1)});
+        llvm::Constant *cpu_model = m.getOrInsertGlobal("__cpu_model",
+            cpu_model_type);
+        // The resolver runs before the constructors, so `__cpu_model` must
+        // be initialized here
+        llvm::FunctionCallee cpu_init = m.getOrInsertFunction(
+            "__cpu_indicator_init", llvm::Type::getVoidTy(context));
+
+        llvm::IRBuilder<> builder(llvm::BasicBlock::Create(context, "entry",
+            resolver));
+        builder.CreateCall(cpu_init);
+        llvm::Value *features = builder.CreateLoad(i32,
+            builder.CreateInBoundsGEP(cpu_model_type, cpu_model,
+                {builder.getInt32(0), builder.getInt32(3), builder.getInt32(0)}));
+        for (size_t i = levels.size(); i-- > 0;) {
+            llvm::Value *mask = llvm::ConstantInt::get(i32, levels[i]->cpu_features);
+            llvm::BasicBlock *supported = llvm::BasicBlock::Create(context,
+                levels[i]->name, resolver);
+            llvm::BasicBlock *next = llvm::BasicBlock::Create(context,
+                "not_" + levels[i]->name, resolver);
+            builder.CreateCondBr(builder.CreateICmpEQ(
+                builder.CreateAnd(features, mask), mask), supported, next);
+            builder.SetInsertPoint(supported);
+            builder.CreateRet(clones[i]);
+            builder.SetInsertPoint(next);
+        }
+        builder.CreateRet(f);
+    }
+
+} // namespace
+
+bool multiversion_module(llvm::Module &m,
+        const std::vector<std::string> &levels,
+        const std::string &target_triple, std::string &error) {
+    llvm::Triple triple(target_triple);
+    if (triple.getArch() != llvm::Triple::x86_64 || !triple.isOSBinFormatELF()) {
+        error = "--multiversion is only supported for x86-64 ELF targets";
+        return false;
+    }
+    for (auto &name: levels) {
+        auto it = std::find_if(isa_levels.begin(), isa_levels.end(),
+            [&](const ISALevel &level) { return level.name == name; });
+        if (it == isa_levels.end()) {
+            error = "Unknown ISA level '" + name + "' in --multiversion"
+                " (supported: avx2, avx512)";
+            return false;
+        }
+    }
+    std::vector<const ISALevel*> selected;
+    for (auto &level: isa_levels) {
+        if (std::find(levels.begin(), levels.end(), level.name) != levels.end()) {
+            selected.push_back(&level);
+        }
+    }
+    if (selected.empty()) return true;
+
+    std::vector<llvm::Function*> functions;
+    for (auto &f: m) {
+        if (f.isDeclaration() || f.hasAvailableExternallyLinkage()
+                || f.getName() == "main" || !has_array_loop(f)) {
+            continue;
+        }
+        functions.push_back(&f);
+    }
+
+    std::map<llvm::Function*, std::vector<llvm::Function*>> clones;
+    for (auto f: functions) {
+        std::string features = f->getFnAttribute("target-features")
+            .getValueAsString().str();
+        for (auto level: selected) {
+            llvm::ValueToValueMapTy vmap;
+            llvm::Function *clone = llvm::CloneFunction(f, vmap);
+            clone->setName(f->getName() + "." + level->name);
+            clone->setLinkage(llvm::GlobalValue::InternalLinkage);
+            clone->setVisibility(llvm::GlobalValue::DefaultVisibility);
+            clone->setComdat(nullptr);
+            clone->addFnAttr("target-features", features.empty()
+                ? level->target_features : features + "," + level->target_features);
+            clones[f].push_back(clone);
+        }
+    }
+    // The clones call the clones of the same level directly
+    for (auto &item: clones) {
+        for (size_t i = 0; i < item.second.size(); i++) {
+            for (auto &bb: *item.second[i]) {
+                for (auto &inst: bb) {
+                    auto call = llvm::dyn_cast<llvm::CallBase>(&inst);
+                    if (!call) continue;
+                    auto it = clones.find(call->getCalledFunction());
+                    if (it != clones.end()) {
+                        call->setCalledFunction(it->second[i]);
+                    }
+                }
+            }
+        }
+    }
+    // Everything else goes through the ifunc
+    for (auto f: functions) {
+        std::string name = f->getName().str();
+        f->setName(name + ".default");
+        llvm::Function *resolver = llvm::Function::Create(
+            llvm::FunctionType::get(f->getType(), false),
+            llvm::GlobalValue::InternalLinkage, name + ".resolver", m);
+        llvm::GlobalIFunc *ifunc = llvm::GlobalIFunc::create(
+            f->getFunctionType(), f->getAddressSpace(), f->getLinkage(), name,
+            resolver, &m);
+        ifunc->setVisibility(f->getVisibility());
+        f->replaceAllUsesWith(ifunc);
+        f->setLinkage(llvm::GlobalValue::InternalLinkage);
+        f->setVisibility(llvm::GlobalValue::DefaultVisibility);
+        f->setComdat(nullptr);
+        create_resolver(m, resolver, f, clones[f], selected);
+    }
+    return true;
+}
+
+} // namespace LCompilers::LPython
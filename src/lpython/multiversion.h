@@ -0,0 +1,34 @@
+#ifndef LPYTHON_MULTIVERSION_H
+#define LPYTHON_MULTIVERSION_H
+
+#include <string>
+#include <vector>
+
+namespace llvm {
+    class Module;
+}
+
+namespace LCompilers::LPython {
+
+    /*
+        Function multiversioning (`--multiversion=avx2,avx512`).
+
+        Every function with a loop that indexes memory is cloned once per
+        ISA level in `levels` (the clone gets the corresponding
+        "target-features"), and the function is replaced by an ifunc whose
+        resolver picks the best clone the CPU supports at load time, using
+        `__cpu_model` from libgcc (or compiler-rt). Calls between the clones
+        of the same level are direct, so they can still be inlined.
+
+        Must be called before the module is optimized, so that the clones
+        are vectorized for their ISA level. Only x86-64 ELF targets are
+        supported (ifuncs are an ELF feature), and the result can only be
+        used for object files, not with the JIT.
+    */
+    bool multiversion_module(llvm::Module &m,
+        const std::vector<std::string> &levels,
+        const std::string &target_triple, std::string &error);
+
+} // namespace LCompilers::LPython
+
+#endif // LPYTHON_MULTIVERSION_H
@@ -0,0 +1,345 @@
+#include <sstream>
+
+#include <llvm/IR/DiagnosticHandler.h>
+#include <llvm/IR/DiagnosticInfo.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/LLVMContext.h>
+
+#include <libasr/asr_utils.h>
+#include <libasr/string_utils.h>
+#include <lpython/opt_remarks.h>
+#include <lpython/utils.h>
+
+namespace LCompilers::LPython {
+
+namespace {
+
+    // Visits the user code, i.e., skips the intrinsic modules
+    template <class Derived>
+    class UserCodeVisitor : public ASR::BaseWalkVisitor<Derived>
+    {
+    public:
+        void visit_Module(const ASR::Module_t &x) {
+            if (x.m_intrinsic) return;
+            ASR::BaseWalkVisitor<Derived>::visit_Module(x);
+        }
+    };
+
+    class SnapshotVisitor : public UserCodeVisitor<SnapshotVisitor>
+    {
+    public:
+        ASRRemarkCollector::Snapshot snapshot;
+        // The position of the function being visited, 0 outside functions
+        uint32_t function = 0;
+
+        SnapshotVisitor() {
+            snapshot.functions.insert(0);
+        }
+
+        void visit_Function(const ASR::Function_t &x) {
+            uint32_t enclosing = function;
+            function = x.base.base.loc.first;
+            snapshot.functions.insert(function);
+            UserCodeVisitor<SnapshotVisitor>::visit_Function(x);
+            function = enclosing;
+        }
+
+        void visit_FunctionCall(const ASR::FunctionCall_t &x) {
+            snapshot.calls[x.base.base.loc.first] = ASRUtils::symbol_name(x.m_name);
+            snapshot.function_of[x.base.base.loc.first] = function;
+            UserCodeVisitor<SnapshotVisitor>::visit_FunctionCall(x);
+        }
+
+        void visit_SubroutineCall(const ASR::SubroutineCall_t &x) {
+            snapshot.calls[x.base.base.loc.first] = ASRUtils::symbol_name(x.m_name);
+            snapshot.function_of[x.base.base.loc.first] = function;
+            UserCodeVisitor<SnapshotVisitor>::visit_SubroutineCall(x);
+        }
+
+        void visit_DoLoop(const ASR::DoLoop_t &x) {
+            snapshot.loops[x.base.base.loc.first] = x.base.base.loc.last;
+            snapshot.function_of[x.base.base.loc.first] = function;
+            UserCodeVisitor<SnapshotVisitor>::visit_DoLoop(x);
+        }
+
+        void visit_WhileLoop(const ASR::WhileLoop_t &x) {
+            snapshot.loops[x.base.base.loc.first] = x.base.base.loc.last;
+            snapshot.function_of[x.base.base.loc.first] = function;
+            UserCodeVisitor<SnapshotVisitor>::visit_WhileLoop(x);
+        }
+    };
+
+    ASRRemarkCollector::Snapshot take_snapshot(ASR::TranslationUnit_t &asr) {
+        SnapshotVisitor v;
+        v.visit_TranslationUnit(asr);
+        return v.snapshot;
+    }
+
+    // The position of every statement and expression of `infile` by its
+    // line and column, which is what asr_to_llvm emits as the debug location
+    class PositionVisitor : public UserCodeVisitor<PositionVisitor>
+    {
+    public:
+        PositionVisitor(LocationManager &lm, const std::string &infile)
+            : lm{lm}, infile{infile} {}
+
+        std::map<std::pair<uint32_t, uint32_t>, uint32_t> positions;
+        std::vector<std::string> intrinsic_modules;
+
+        void visit_Module(const ASR::Module_t &x) {
+            if (x.m_intrinsic) intrinsic_modules.push_back(x.m_name);
+            UserCodeVisitor<PositionVisitor>::visit_Module(x);
+        }
+
+        void visit_stmt(const ASR::stmt_t &x) {
+            add(x.base.loc);
+            UserCodeVisitor<PositionVisitor>::visit_stmt(x);
+        }
+
+        void visit_expr(const ASR::expr_t &x) {
+            add(x.base.loc);
+            UserCodeVisitor<PositionVisitor>::visit_expr(x);
+        }
+
+    private:
+        LocationManager &lm;
+        const std::string &infile;
+
+        void add(const Location &loc) {
+            uint32_t line, column;
+            std::string filename;
+            lm.pos_to_linecol(lm.output_to_input_pos(loc.first, false),
+                line, column, filename);
+            if (filename == infile) positions.insert({{line, column}, loc.first});
+        }
+    };
+
+    Location point(uint32_t position) {
+        Location loc;
+        loc.first = position;
+        loc.last = position;
+        return loc;
+    }
+
+    class RemarkHandler : public llvm::DiagnosticHandler {
+    public:
+        RemarkHandler(llvm::DiagnosticHandler *old_handler,
+                const PositionVisitor &positions, OptRemarks &remarks)
+            : old_handler{old_handler}, positions{positions}, remarks{remarks} {}
+
+        bool handleDiagnostics(const llvm::DiagnosticInfo &di) override {
+            auto r = llvm::dyn_cast<llvm::DiagnosticInfoOptimizationBase>(&di);
+            if (!r) return old_handler && old_handler->handleDiagnostics(di);
+            // The runtime library is linked separately, it cannot be inlined
+            if (r->isMissed() && r->getPassName() == "inline"
+                    && r->getRemarkName() == "NoDefinition") {
+                return true;
+            }
+            std::string function = r->getFunction().getName().str();
+            for (auto &module: positions.intrinsic_modules) {
+                if (startswith(function, "__module_" + module + "_")) return true;
+            }
+            OptRemark remark;
+            if (r->isLocationAvailable()) {
+                auto it = positions.positions.find({r->getLocation().getLine(),
+                    r->getLocation().getColumn()});
+                if (it == positions.positions.end()) return true;
+                remark.loc = point(it->second);
+            } else {
+                remark.has_loc = false;
+                remark.loc = point(0);
+            }
+            remark.kind = r->isPassed() ? OptRemark::Kind::Passed
+                : r->isMissed() ? OptRemark::Kind::Missed
+                : OptRemark::Kind::Analysis;
+            remark.pass = r->getPassName().str();
+            remark.name = r->getRemarkName().str();
+            remark.function = function;
+            remark.message = r->getMsg();
+            remarks.add(remark);
+            return true;
+        }
+
+        // Checked by the passes before they build any remark (the default
+        // only looks at the `-pass-remarks*` command line options)
+        bool isAnyRemarkEnabled() const override {
+            return true;
+        }
+
+        // The analysis remarks of the loop vectorizer explain why a loop
+        // was not vectorized, the others are mostly noise
+        bool isAnalysisRemarkEnabled(llvm::StringRef pass) const override {
+            return pass == "loop-vectorize";
+        }
+
+        bool isMissedOptRemarkEnabled(llvm::StringRef /*pass*/) const override {
+            return true;
+        }
+
+        bool isPassedOptRemarkEnabled(llvm::StringRef /*pass*/) const override {
+            return true;
+        }
+
+    private:
+        llvm::DiagnosticHandler *old_handler;
+        const PositionVisitor &positions;
+        OptRemarks &remarks;
+    };
+
+    std::string kind_to_str(OptRemark::Kind kind) {
+        switch (kind) {
+            case OptRemark::Kind::Passed: return "passed";
+            case OptRemark::Kind::Missed: return "missed";
+            case OptRemark::Kind::Analysis: return "analysis";
+        }
+        return "";
+    }
+
+} // namespace
+
+void OptRemarks::add(const OptRemark &remark) {
+    // The passes can report the same decision several times, e.g. for each
+    // function a call was inlined into
+    if (!added.insert({remark.pass, remark.name, remark.has_loc,
+            remark.loc.first, remark.has_loc ? "" : remark.function,
+            remark.message}).second) {
+        return;
+    }
+    remarks.push_back(remark);
+}
+
+ASRRemarkCollector::ASRRemarkCollector(ASR::TranslationUnit_t &asr,
+        OptRemarks &remarks, bool fast)
+    : asr{asr}, remarks{remarks}, fast{fast}, before{take_snapshot(asr)} {}
+
+void ASRRemarkCollector::passes_applied() {
+    Snapshot after = take_snapshot(asr);
+    // The calls and loops of the functions that were removed (e.g., unused
+    // ones) disappear with them
+    auto removed = [&](uint32_t position) {
+        return after.functions.find(before.function_of[position])
+            == after.functions.end();
+    };
+    OptRemark remark;
+    remark.kind = OptRemark::Kind::Passed;
+
+    remark.pass = "inline_function_calls";
+    remark.name = "Inlined";
+    remark.inferred = true;
+    for (auto &call: before.calls) {
+        if (!fast || after.calls.find(call.first) != after.calls.end()
+                || removed(call.first)) {
+            continue;
+        }
+        remark.message = "inlined call to '" + call.second + "'";
+        remark.loc = point(call.first);
+        remarks.add(remark);
+    }
+
+    remark.pass = "loop_vectorise";
+    remark.name = "Vectorized";
+    remark.inferred = false;
+    for (auto &call: after.calls) {
+        if (before.calls.find(call.first) != before.calls.end()
+                || !startswith(call.second, "vector_copy")) {
+            continue;
+        }
+        // The innermost loop the call replaced the body of
+        uint32_t position = call.first;
+        for (auto &loop: before.loops) {
+            if (loop.first > call.first) break;
+            if (call.first <= loop.second) position = loop.first;
+        }
+        remark.message = "loop vectorized (using '" + call.second + "')";
+        remark.loc = point(position);
+        remarks.add(remark);
+    }
+
+    remark.pass = "loop_unroll";
+    remark.name = "FullyUnrolled";
+    remark.message = "loop fully unrolled";
+    remark.inferred = true;
+    for (auto &loop: before.loops) {
+        if (!fast || after.loops.find(loop.first) != after.loops.end()
+                || removed(loop.first)) {
+            continue;
+        }
+        remark.loc = point(loop.first);
+        remarks.add(remark);
+    }
+}
+
+struct LLVMRemarkCollector::Impl {
+    llvm::LLVMContext &context;
+    std::unique_ptr<llvm::DiagnosticHandler> old_handler;
+    PositionVisitor positions;
+
+    Impl(llvm::LLVMContext &context, LocationManager &lm,
+        const std::string &infile) : context{context}, positions(lm, infile) {}
+};
+
+LLVMRemarkCollector::LLVMRemarkCollector(llvm::LLVMContext &context,
+        ASR::TranslationUnit_t &asr, LocationManager &lm,
+        const std::string &infile, OptRemarks &remarks)
+        : impl{std::make_unique<Impl>(context, lm, infile)} {
+    impl->positions.visit_TranslationUnit(asr);
+    impl->old_handler = context.getDiagnosticHandler();
+    context.setDiagnosticHandler(std::make_unique<RemarkHandler>(
+        impl->old_handler.get(), impl->positions, remarks));
+}
+
+LLVMRemarkCollector::~LLVMRemarkCollector() {
+    impl->context.setDiagnosticHandler(std::move(impl->old_handler));
+}
+
+void opt_remarks_to_diagnostics(const OptRemarks &remarks,
+        diag::Diagnostics &diagnostics) {
+    for (auto &r: remarks.remarks) {
+        std::string message = r.message + " [" + r.pass
+            + (r.inferred ? ", inferred" : "") + "]";
+        if (r.kind == OptRemark::Kind::Missed) {
+            message = "missed: " + message;
+        } else if (r.kind == OptRemark::Kind::Analysis) {
+            message = "analysis: " + message;
+        }
+        if (r.has_loc) {
+            diagnostics.add(diag::Diagnostic(message, diag::Level::Note,
+                diag::Stage::CodeGen, {diag::Label("", {r.loc})}));
+        } else {
+            diagnostics.add(diag::Diagnostic("in function '" + r.function
+                + "': " + message, diag::Level::Note, diag::Stage::CodeGen, {}));
+        }
+    }
+}
+
+std::string opt_remarks_to_json(const OptRemarks &remarks,
+        const LocationManager &lm, const std::string &filename) {
+    std::stringstream out;
+    out << "{\"file\": " << json_string(filename) << ", \"remarks\": [";
+    for (size_t i = 0; i < remarks.remarks.size(); i++) {
+        const OptRemark &r = remarks.remarks[i];
+        if (i > 0) out << ", ";
+        out << "{\"kind\": " << json_string(kind_to_str(r.kind))
+            << ", \"pass\": " << json_string(r.pass)
+            << ", \"name\": " << json_string(r.name)
+            << ", \"function\": " << json_string(r.function);
+        if (r.has_loc) {
+            uint32_t line, column;
+            std::string remark_filename;
+            lm.pos_to_linecol(lm.output_to_input_pos(r.loc.first, false),
+                line, column, remark_filename);
+            out << ", \"file\": " << json_string(remark_filename)
+                << ", \"line\": " << line
+                << ", \"column\": " << column;
+        } else {
+            out << ", \"file\": " << json_string(filename)
+                << ", \"line\": null, \"column\": null";
+        }
+        out << ", \"message\": " << json_string(r.message)
+            << ", \"inferred\": " << (r.inferred ? "true" : "false") << "}";
+    }
+    out << "]}";
+    return out.str();
+}
+
+} // namespace LCompilers::LPython
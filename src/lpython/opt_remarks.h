@@ -0,0 +1,134 @@
+#ifndef LPYTHON_OPT_REMARKS_H
+#define LPYTHON_OPT_REMARKS_H
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <libasr/asr.h>
+#include <libasr/diagnostics.h>
+#include <libasr/location.h>
+
+namespace llvm {
+    class LLVMContext;
+}
+
+namespace LCompilers::LPython {
+
+    /*
+        Optimization remarks (`--opt-remarks`).
+
+        A remark records a decision of an optimization: either of the ASR
+        passes that transform the Python code (`inline_function_calls`,
+        `loop_vectorise`, `loop_unroll`) or of the LLVM passes run by
+        `--fast` (inlining, loop vectorization and unrolling, ...). The ASR
+        remarks point to the Python source through the locations of the ASR
+        nodes. The LLVM remarks only have a location if the module has debug
+        information (`--debug-info --debug-with-line-column`), whose line and
+        column are mapped back to the ASR node they were generated from;
+        otherwise they only name the LLVM function.
+    */
+    struct OptRemark {
+        enum class Kind { Passed, Missed, Analysis };
+
+        Kind kind;
+        std::string pass;     // ASR pass or LLVM pass name
+        std::string name;     // Identifies the kind of decision
+        std::string function; // The LLVM function, empty for ASR remarks
+        std::string message;
+        bool has_loc = true;
+        Location loc;
+        // Deduced from the ASR before and after all the passes, rather than
+        // reported by the pass (see ASRRemarkCollector)
+        bool inferred = false;
+    };
+
+    struct OptRemarks {
+        std::vector<OptRemark> remarks;
+
+        void add(const OptRemark &remark);
+
+    private:
+        // pass, name, has_loc, position, function (without a location) and
+        // message of the remarks added so far
+        std::set<std::tuple<std::string, std::string, bool, uint32_t,
+            std::string, std::string>> added;
+    };
+
+    /*
+        Records what the ASR optimization passes did, by comparing the calls
+        and loops of the user code (not the intrinsic modules) before the
+        passes (when constructed) and after them (`passes_applied`):
+
+        * inline_function_calls: a call that disappeared was inlined
+        * loop_vectorise: a loop that now calls a `vector_copy` routine was
+          vectorized
+        * loop_unroll: a loop that disappeared was fully unrolled
+
+        The PassManager does not report the individual passes. Only the
+        `vector_copy` calls are specific to one pass. A call or a loop can
+        also disappear in other passes (e.g., when it is evaluated at compile
+        time), so the inlining and unrolling remarks are marked as inferred,
+        and they are only made when the pass is enabled (`--fast`).
+    */
+    class ASRRemarkCollector {
+    public:
+        // `fast`: the optimization passes (inlining, unrolling) are applied
+        ASRRemarkCollector(ASR::TranslationUnit_t &asr, OptRemarks &remarks,
+            bool fast);
+
+        void passes_applied();
+
+        // The calls and loops of the user code, by their position
+        struct Snapshot {
+            std::map<uint32_t, std::string> calls;
+            std::map<uint32_t, uint32_t> loops; // first -> last
+            // The function each call and loop is in, and the functions
+            std::map<uint32_t, uint32_t> function_of;
+            std::set<uint32_t> functions;
+        };
+
+    private:
+        ASR::TranslationUnit_t &asr;
+        OptRemarks &remarks;
+        bool fast;
+        Snapshot before;
+    };
+
+    /*
+        Collects the optimization remarks of the LLVM passes run on the
+        modules of `context` while it is alive (it replaces the diagnostic
+        handler of the context and restores it afterwards).
+
+        `asr` is the ASR the module was generated from for `infile`. The
+        remarks without a location (no debug information) are kept without
+        one; those whose location does not correspond to an ASR node of
+        `infile` are dropped, as are the remarks about the intrinsic modules
+        and the missed inlining of functions without a body (the runtime
+        library). The codegen options are not changed to get locations.
+    */
+    class LLVMRemarkCollector {
+    public:
+        LLVMRemarkCollector(llvm::LLVMContext &context,
+            ASR::TranslationUnit_t &asr, LocationManager &lm,
+            const std::string &infile, OptRemarks &remarks);
+        ~LLVMRemarkCollector();
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> impl;
+    };
+
+    // Adds the remarks as notes, to be rendered with the other diagnostics
+    void opt_remarks_to_diagnostics(const OptRemarks &remarks,
+        diag::Diagnostics &diagnostics);
+
+    std::string opt_remarks_to_json(const OptRemarks &remarks,
+        const LocationManager &lm, const std::string &filename);
+
+} // namespace LCompilers::LPython
+
+#endif // LPYTHON_OPT_REMARKS_H
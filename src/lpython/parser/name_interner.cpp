@@ -0,0 +1,43 @@
+#include <cstring>
+
+#include <lpython/parser/name_interner.h>
+#include <lpython/utils.h>
+
+namespace LCompilers::LPython {
+
+char *NameInterner::intern(Allocator &al, const char *s, size_t n) {
+    // Keep the load factor below 1/2
+    if (2*(count+1) > table.size()) grow();
+    uint32_t hash = (uint32_t)fnv1a_hash(s, n);
+    size_t mask = table.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        Entry &e = table[i];
+        if (e.s == nullptr) {
+            e.s = al.allocate<char>(n + 1);
+            std::memcpy(e.s, s, n);
+            e.s[n] = '\0';
+            e.n = n;
+            e.hash = hash;
+            count++;
+            return e.s;
+        }
+        if (e.hash == hash && e.n == n && std::memcmp(e.s, s, n) == 0) {
+            return e.s;
+        }
+    }
+}
+
+void NameInterner::grow() {
+    std::vector<Entry> old;
+    old.swap(table);
+    table.resize(old.empty() ? 256 : 2*old.size(), Entry{nullptr, 0, 0});
+    size_t mask = table.size() - 1;
+    for (auto &e: old) {
+        if (e.s == nullptr) continue;
+        size_t i = e.hash & mask;
+        while (table[i].s != nullptr) i = (i + 1) & mask;
+        table[i] = e;
+    }
+}
+
+} // namespace LCompilers::LPython
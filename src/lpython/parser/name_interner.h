@@ -0,0 +1,47 @@
+#ifndef LPYTHON_PARSER_NAME_INTERNER_H
+#define LPYTHON_PARSER_NAME_INTERNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <libasr/alloc.h>
+
+namespace LCompilers::LPython {
+
+/*
+    The identifiers of one parse, each stored once: the tokenizer returns
+    every TK_NAME as the interned copy, and the AST (`Name_t::m_id`, and the
+    names taken from it) points to the same NUL terminated string. A module
+    that uses a name a thousand times thus allocates it once, and two names
+    from the same parse are equal iff their pointers are.
+
+    The strings live in the allocator passed to `intern`, which must be the
+    one of the AST.
+*/
+class NameInterner
+{
+public:
+    // Returns the interned copy of the `n` bytes at `s`
+    char *intern(Allocator &al, const char *s, size_t n);
+
+    // The number of distinct names
+    size_t size() const { return count; }
+
+private:
+    struct Entry {
+        char *s;
+        uint32_t n;
+        uint32_t hash;
+    };
+
+    // Open addressing with linear probing, the size is a power of two
+    std::vector<Entry> table;
+    size_t count = 0;
+
+    void grow();
+};
+
+} // namespace LCompilers::LPython
+
+#endif // LPYTHON_PARSER_NAME_INTERNER_H
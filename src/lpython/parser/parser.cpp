@@ -1,8 +1,12 @@
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <string>
 #include <sstream>
 #include <fstream>
 #include <chrono>
+#include <cstring>
+#include <thread>
 
 #include <lpython/parser/parser.h>
 #include <lpython/parser/parser.tab.hh>
@@ -11,35 +15,253 @@
 #include <libasr/utils.h>
 #include <lpython/parser/parser_exception.h>
 #include <lpython/python_serialization.h>
+#include <lpython/ast_cache.h>
 
 namespace LCompilers::LPython {
 
+namespace {
+
+    template <class Input>
+    Result<LPython::AST::Module_t*> parse_input(Allocator &al, const Input &s,
+            uint32_t prev_loc, diag::Diagnostics &diagnostics)
+    {
+        Parser p(al, diagnostics);
+        try {
+            p.parse(s, prev_loc);
+        } catch (const parser_local::TokenizerError &e) {
+            Error error;
+            diagnostics.diagnostics.push_back(e.d);
+            return error;
+        } catch (const parser_local::ParserError &e) {
+            Error error;
+            diagnostics.diagnostics.push_back(e.d);
+            return error;
+        }
+
+        Location l;
+        if (p.result.size() == 0) {
+            l.first=0;
+            l.last=0;
+        } else {
+            l.first=p.result[0]->base.loc.first;
+            l.last=p.result[p.result.size()-1]->base.loc.last;
+        }
+        return (LPython::AST::Module_t*)LPython::AST::make_Module_t(al, l,
+            p.result.p, p.result.size(), p.type_ignore.p, p.type_ignore.size());
+    }
+
+    bool starts_with(const char *p, const char *end, const char *prefix) {
+        size_t n = std::strlen(prefix);
+        return (size_t)(end - p) >= n && std::memcmp(p, prefix, n) == 0;
+    }
+
+    // A line that starts a top level definition
+    bool is_definition(const char *p, const char *end) {
+        return *p == '@' || starts_with(p, end, "def ")
+            || starts_with(p, end, "class ")
+            || starts_with(p, end, "async def ");
+    }
+
+    /*
+        The offsets of the lines of `s` at which a top level definition
+        starts, i.e., where the input can be split into chunks that parse
+        independently. It only follows what the tokenizer needs to know
+        where a line starts a new statement at column 0: strings (also
+        triple quoted), comments, brackets and line continuations.
+        A definition preceded by its decorators is not a boundary, the
+        first decorator is.
+    */
+    std::vector<size_t> definition_boundaries(const char *s, size_t n) {
+        std::vector<size_t> boundaries;
+        const char *end = s + n;
+        const char *p = s;
+        size_t parenlevel = 0;
+        bool after_decorator = false;
+        bool line_start = true;
+        while (p < end) {
+            if (line_start) {
+                line_start = false;
+                if (parenlevel == 0) {
+                    const char *q = p;
+                    while (q < end && (*q == ' ' || *q == '\t' || *q == '\v')) q++;
+                    // Blank lines and comments do not separate a decorator
+                    // from its definition
+                    if (q < end && *q != '\n' && *q != '\r' && *q != '#') {
+                        if (q == p && is_definition(p, end)) {
+                            if (!after_decorator && p != s) {
+                                boundaries.push_back(p - s);
+                            }
+                            after_decorator = (*p == '@');
+                        } else {
+                            after_decorator = false;
+                        }
+                    }
+                }
+            }
+            char c = *p;
+            if (c == '\n') {
+                line_start = true;
+                p++;
+            } else if (c == '#') {
+                p = (const char *)std::memchr(p, '\n', end - p);
+                if (!p) p = end;
+            } else if (c == '\\') {
+                // A line continuation, or an escaped character
+                p = std::min(p + 2, end);
+            } else if (c == '(' || c == '[' || c == '{') {
+                parenlevel++;
+                p++;
+            } else if (c == ')' || c == ']' || c == '}') {
+                if (parenlevel > 0) parenlevel--;
+                p++;
+            } else if (c == '"' || c == '\'') {
+                bool triple = end - p >= 3 && p[1] == c && p[2] == c;
+                p += triple ? 3 : 1;
+                while (p < end) {
+                    if (*p == '\\') {
+                        p = std::min(p + 2, end);
+                    } else if (*p == c && (!triple
+                            || (end - p >= 3 && p[1] == c && p[2] == c))) {
+                        p += triple ? 3 : 1;
+                        break;
+                    } else if (*p == '\n' && !triple) {
+                        // Not terminated, the tokenizer reports it
+                        break;
+                    } else {
+                        p++;
+                    }
+                }
+            } else {
+                p++;
+            }
+        }
+        return boundaries;
+    }
+
+    // The result of parsing one chunk
+    struct Chunk {
+        size_t start, end;
+        bool ok = false;
+        Vec<LPython::AST::stmt_t*> result;
+        Vec<LPython::AST::type_ignore_t*> type_ignore;
+        diag::Diagnostics diagnostics;
+    };
+
+    bool parse_chunk(Allocator &al, const char *s, Chunk &chunk,
+            uint32_t prev_loc) {
+        // Each chunk ends with a newline, so it is parsed in place
+        Parser p(al, chunk.diagnostics);
+        try {
+            p.parse(s + chunk.start, chunk.end - chunk.start,
+                prev_loc + chunk.start);
+        } catch (...) {
+            // Reported by parsing the whole input again
+            return false;
+        }
+        chunk.result = p.result;
+        chunk.type_ignore = p.type_ignore;
+        return true;
+    }
+
+} // namespace
+
 Result<LPython::AST::Module_t*> parse(Allocator &al, const std::string &s,
         uint32_t prev_loc, diag::Diagnostics &diagnostics)
 {
-    Parser p(al, diagnostics);
-    try {
-        p.parse(s, prev_loc);
-    } catch (const parser_local::TokenizerError &e) {
-        Error error;
-        diagnostics.diagnostics.push_back(e.d);
-        return error;
-    } catch (const parser_local::ParserError &e) {
-        Error error;
-        diagnostics.diagnostics.push_back(e.d);
-        return error;
+    return parse_input(al, s, prev_loc, diagnostics);
+}
+
+Result<LPython::AST::Module_t*> parse(Allocator &al, const SourceBuffer &s,
+        uint32_t prev_loc, diag::Diagnostics &diagnostics)
+{
+    return parse_input(al, s, prev_loc, diagnostics);
+}
+
+Result<LPython::AST::Module_t*> parse_parallel(Allocator &al,
+        std::vector<std::unique_ptr<Allocator>> &arenas,
+        const SourceBuffer &s, uint32_t prev_loc,
+        diag::Diagnostics &diagnostics, size_t jobs)
+{
+    if (jobs <= 1 || s.text_size() < min_parallel_parse_size) {
+        return parse(al, s, prev_loc, diagnostics);
+    }
+    // A few chunks per thread, so that the threads finish at about the same
+    // time even if the definitions differ in size
+    size_t n = s.text_size();
+    size_t chunk_size = n / (4 * jobs) + 1;
+    std::vector<Chunk> chunks;
+    size_t start = 0;
+    for (size_t boundary: definition_boundaries(s.data(), n)) {
+        if (boundary - start >= chunk_size) {
+            chunks.emplace_back();
+            chunks.back().start = start;
+            chunks.back().end = boundary;
+            start = boundary;
+        }
+    }
+    chunks.emplace_back();
+    chunks.back().start = start;
+    chunks.back().end = n;
+    if (chunks.size() == 1) {
+        return parse(al, s, prev_loc, diagnostics);
+    }
+
+    jobs = std::min(jobs, chunks.size());
+    std::atomic<size_t> next_chunk(0);
+    auto worker = [&](Allocator &chunk_al) {
+        for (size_t i = next_chunk++; i < chunks.size(); i = next_chunk++) {
+            chunks[i].ok = parse_chunk(chunk_al, s.data(), chunks[i], prev_loc);
+        }
+    };
+    // Each thread allocates the nodes of its chunks in its own arena, the
+    // calling thread in `al`
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < jobs; i++) {
+        arenas.push_back(std::make_unique<Allocator>(1024*1024));
+        workers.emplace_back(worker, std::ref(*arenas.back()));
+    }
+    worker(al);
+    for (auto &t: workers) {
+        t.join();
+    }
+
+    size_t n_stmts = 0, n_type_ignores = 0;
+    for (auto &chunk: chunks) {
+        if (!chunk.ok) {
+            // Parse everything again to report the error exactly as the
+            // sequential parser does (a chunk can also fail because of an
+            // error in an earlier one, e.g. an unterminated string)
+            return parse(al, s, prev_loc, diagnostics);
+        }
+        n_stmts += chunk.result.size();
+        n_type_ignores += chunk.type_ignore.size();
+    }
+    Vec<LPython::AST::stmt_t*> body;
+    body.reserve(al, n_stmts);
+    Vec<LPython::AST::type_ignore_t*> type_ignore;
+    type_ignore.reserve(al, n_type_ignores);
+    for (auto &chunk: chunks) {
+        for (size_t i = 0; i < chunk.result.size(); i++) {
+            body.push_back(al, chunk.result[i]);
+        }
+        for (size_t i = 0; i < chunk.type_ignore.size(); i++) {
+            type_ignore.push_back(al, chunk.type_ignore[i]);
+        }
+        diagnostics.diagnostics.insert(diagnostics.diagnostics.end(),
+            chunk.diagnostics.diagnostics.begin(),
+            chunk.diagnostics.diagnostics.end());
     }
 
     Location l;
-    if (p.result.size() == 0) {
+    if (body.size() == 0) {
         l.first=0;
         l.last=0;
     } else {
-        l.first=p.result[0]->base.loc.first;
-        l.last=p.result[p.result.size()-1]->base.loc.last;
+        l.first=body[0]->base.loc.first;
+        l.last=body[body.size()-1]->base.loc.last;
     }
     return (LPython::AST::Module_t*)LPython::AST::make_Module_t(al, l,
-        p.result.p, p.result.size(), p.type_ignore.p, p.type_ignore.size());
+        body.p, body.size(), type_ignore.p, type_ignore.size());
 }
 
 void Parser::parse(const std::string &input, uint32_t prev_loc)
@@ -57,6 +279,20 @@ void Parser::parse(const std::string &input, uint32_t prev_loc)
     throw parser_local::ParserError("Parsing unsuccessful (internal compiler error)");
 }
 
+void Parser::parse(const char *input, size_t size, uint32_t prev_loc)
+{
+    m_tokenizer.set_string(input, size, prev_loc);
+    if (yyparse(*this) == 0) {
+        return;
+    }
+    throw parser_local::ParserError("Parsing unsuccessful (internal compiler error)");
+}
+
+void Parser::parse(const SourceBuffer &input, uint32_t prev_loc)
+{
+    parse(input.data(), input.text_size(), prev_loc);
+}
+
 void Parser::handle_yyerror(const Location &loc, const std::string &msg)
 {
     std::string message;
@@ -113,24 +349,44 @@ std::string unique_filename(const std::string &prefix) {
 }
 
 Result<LPython::AST::ast_t*> parse_python_file(Allocator &al,
-        const std::string &/*runtime_library_dir*/,
+        const std::string &runtime_library_dir,
         const std::string &infile,
         diag::Diagnostics &diagnostics,
         uint32_t prev_loc,
+        bool new_parser) {
+    SourceBuffer source;
+    if (!source.load_file(infile)) {
+        std::cerr << "File '" << infile << "' cannot be opened." << std::endl;
+        exit(1);
+    }
+    return parse_python_file(al, runtime_library_dir, source, diagnostics,
+        prev_loc, new_parser);
+}
+
+Result<LPython::AST::ast_t*> parse_python_file(Allocator &al,
+        const std::string &/*runtime_library_dir*/,
+        const SourceBuffer &source,
+        diag::Diagnostics &diagnostics,
+        uint32_t prev_loc,
         [[maybe_unused]] bool new_parser) {
-    LPython::AST::ast_t* ast;
     // We will be using the new parser from now on
     new_parser = true;
     LCOMPILERS_ASSERT(new_parser)
-    std::string input = read_file_ok(infile);
-    Result<LPython::AST::Module_t*> res = parse(al, input, prev_loc, diagnostics);
+    LPython::AST::ast_t* ast = load_ast_cache_entry(al, source.data(),
+        source.size(), prev_loc);
+    if (ast) return ast;
+    size_t n_diagnostics = diagnostics.diagnostics.size();
+    Result<LPython::AST::Module_t*> res = parse(al, source, prev_loc, diagnostics);
     if (res.ok) {
         ast = (LPython::AST::ast_t*)res.result;
+        if (diagnostics.diagnostics.size() == n_diagnostics) {
+            save_ast_cache_entry(source.data(), source.size(), prev_loc, *ast);
+        }
+        return ast;
     } else {
         LCOMPILERS_ASSERT(diagnostics.has_error())
         return Error();
     }
-    return ast;
 }
 
 
@@ -1,9 +1,14 @@
 #ifndef LPYTHON_PARSER_PARSER_H
 #define LPYTHON_PARSER_PARSER_H
 
+#include <memory>
+#include <vector>
+
 #include "lpython/python_ast.h"
 #include <libasr/containers.h>
 #include <libasr/diagnostics.h>
+#include <lpython/parser/name_interner.h>
+#include <lpython/parser/source_buffer.h>
 #include <lpython/parser/tokenizer.h>
 
 namespace LCompilers::LPython {
@@ -17,6 +22,7 @@ public:
     diag::Diagnostics &diag;
     Allocator &m_a;
     Tokenizer m_tokenizer;
+    NameInterner m_names;
     Vec<LPython::AST::stmt_t*> result;
     Vec<LPython::AST::type_ignore_t*> type_ignore;
 
@@ -24,9 +30,18 @@ public:
             : diag{diagnostics}, m_a{al} {
         result.reserve(al, 32);
         type_ignore.reserve(al, 4);
+        m_tokenizer.names = &m_names;
     }
+    Parser(const Parser &) = delete;
+    Parser &operator=(const Parser &) = delete;
 
     void parse(const std::string &input, uint32_t prev_loc);
+    // Parses `size` bytes at `input` in place, without a copy. The bytes must
+    // end with a newline and the buffer must be NUL terminated at or after
+    // `input + size`
+    void parse(const char *input, size_t size, uint32_t prev_loc);
+    // Parses `input` in place, without a copy
+    void parse(const SourceBuffer &input, uint32_t prev_loc);
     void handle_yyerror(const Location &loc, const std::string &msg);
 };
 
@@ -35,6 +50,29 @@ public:
 Result<LPython::AST::Module_t*> parse(Allocator &al,
     const std::string &s, uint32_t prev_loc,
     diag::Diagnostics &diagnostics);
+Result<LPython::AST::Module_t*> parse(Allocator &al,
+    const SourceBuffer &s, uint32_t prev_loc,
+    diag::Diagnostics &diagnostics);
+
+// Smaller inputs are always parsed by `parse_parallel` on the calling thread
+const size_t min_parallel_parse_size = 256*1024;
+
+/*
+    Parses `s` like `parse` does, using up to `jobs` threads: the input is
+    split into chunks at top level definitions (`def`, `class` and their
+    decorators at column 0), each is parsed on its own and the statements
+    are collected into one module. The locations are the same as if the
+    whole input was parsed at once.
+
+    The other threads allocate their nodes in arenas that are added to
+    `arenas`, which must live as long as the AST. If a chunk fails to parse,
+    the whole input is parsed again sequentially, so that the diagnostics
+    are the same as those of `parse`.
+*/
+Result<LPython::AST::Module_t*> parse_parallel(Allocator &al,
+    std::vector<std::unique_ptr<Allocator>> &arenas,
+    const SourceBuffer &s, uint32_t prev_loc,
+    diag::Diagnostics &diagnostics, size_t jobs);
 
 Result<LPython::AST::ast_t*> parse_python_file(Allocator &al,
         const std::string &runtime_library_dir,
@@ -42,6 +80,14 @@ Result<LPython::AST::ast_t*> parse_python_file(Allocator &al,
         diag::Diagnostics &diagnostics,
         uint32_t prev_loc, bool new_parser);
 
+// The same for a file that is already loaded (e.g. to set up the
+// LocationManager from the same buffer)
+Result<LPython::AST::ast_t*> parse_python_file(Allocator &al,
+        const std::string &runtime_library_dir,
+        const SourceBuffer &source,
+        diag::Diagnostics &diagnostics,
+        uint32_t prev_loc, bool new_parser);
+
 } // namespace LCompilers::LPython
 
 #endif
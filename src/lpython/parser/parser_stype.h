@@ -5,7 +5,7 @@
 #include <lpython/python_ast.h>
 #include <libasr/location.h>
 #include <libasr/containers.h>
-#include <libasr/bigint.h>
+#include <lpython/bigint.h>
 
 namespace LCompilers::LPython {
 
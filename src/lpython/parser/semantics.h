@@ -796,8 +796,10 @@ static inline ast_t* concat_string(Allocator &al, Location &l,
     return tmp;
 }
 
+// The tokenizer returns TK_NAME interned, `x.p` is NUL terminated and
+// shared by all uses of the name
 #define SYMBOL(x, l) make_Name_t(p.m_a, l, \
-        x.c_str(p.m_a), expr_contextType::Load)
+        x.p, expr_contextType::Load)
 // `x.int_n` is of type BigInt but we store the int64_t directly in AST
 #define INTEGER(x, l) make_ConstantInt_t(p.m_a, l, x, nullptr)
 #define STRING1(x, l) make_ConstantStr_t(p.m_a, l, str_unescape_c(p.m_a, x), nullptr)
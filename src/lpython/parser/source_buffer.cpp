@@ -0,0 +1,118 @@
+#include <cstring>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <libasr/utils.h>
+#include <lpython/parser/source_buffer.h>
+
+namespace LCompilers::LPython {
+
+SourceBuffer::~SourceBuffer() {
+    release();
+}
+
+void SourceBuffer::release() {
+#ifndef _WIN32
+    if (mapped_size > 0) munmap(buf, mapped_size);
+#endif
+    heap.reset();
+    buf = nullptr;
+    file_size = 0;
+    text_n = 0;
+    mapped_size = 0;
+}
+
+// A zeroed heap buffer for `size` bytes of contents
+char *SourceBuffer::allocate(size_t size) {
+    size_t n = size + 2 + padding;
+    heap.reset(new char[n]);
+    std::memset(heap.get() + size, 0, n - size);
+    buf = heap.get();
+    return buf;
+}
+
+void SourceBuffer::finish(size_t size) {
+    file_size = size;
+    text_n = size;
+    // The bytes after the contents are already zero
+    if (size == 0 || buf[size-1] != '\n') buf[text_n++] = '\n';
+}
+
+void SourceBuffer::load_string(const std::string &s) {
+    release();
+    std::memcpy(allocate(s.size()), s.data(), s.size());
+    finish(s.size());
+}
+
+bool SourceBuffer::load_file(const std::string &filename) {
+    release();
+#ifndef _WIN32
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        size_t size = st.st_size;
+        if (size >= mmap_threshold) {
+            // Reserve zeroed anonymous pages for the contents and the
+            // padding, then map the file over the beginning of them: reading
+            // past the last page of the file would be an error otherwise
+            size_t page = sysconf(_SC_PAGESIZE);
+            size_t total = (size + 2 + padding + page - 1) / page * page;
+            void *region = mmap(nullptr, total, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (region != MAP_FAILED) {
+                if (mmap(region, size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_FIXED, fd, 0) != MAP_FAILED) {
+                    close(fd);
+                    buf = (char *)region;
+                    mapped_size = total;
+                    finish(size);
+                    return true;
+                }
+                munmap(region, total);
+            }
+        }
+        char *p = allocate(size);
+        size_t n = 0;
+        while (n < size) {
+            ssize_t r = read(fd, p + n, size - n);
+            if (r <= 0) break;
+            n += r;
+        }
+        close(fd);
+        if (n != size) {
+            release();
+            return false;
+        }
+        finish(size);
+        return true;
+    }
+    close(fd);
+#endif
+    // Not a regular file (or Windows)
+    std::string s;
+    if (!read_file(filename, s)) return false;
+    load_string(s);
+    return true;
+}
+
+void SourceBuffer::init_location_manager(LocationManager &lm) const {
+    LocationManager::FileLocations &fl = lm.files.back();
+    fl.out_start.push_back(0);
+    fl.in_start.push_back(0);
+    fl.in_start.push_back(file_size);
+    fl.out_start.push_back(file_size);
+    const char *p = buf;
+    const char *end = buf + file_size;
+    while ((p = (const char *)std::memchr(p, '\n', end - p)) != nullptr) {
+        fl.in_newlines.push_back(p - buf);
+        p++;
+    }
+}
+
+} // namespace LCompilers::LPython
@@ -0,0 +1,63 @@
+#ifndef LPYTHON_PARSER_SOURCE_BUFFER_H
+#define LPYTHON_PARSER_SOURCE_BUFFER_H
+
+#include <memory>
+#include <string>
+
+#include <libasr/location.h>
+
+namespace LCompilers::LPython {
+
+/*
+    The contents of a source file in the form the tokenizer needs them:
+    ending with a newline (added if the file does not end with one), followed
+    by a NUL byte and `padding` zero bytes, so that the tokenizer can always
+    read ahead a fixed number of bytes without checking for the end.
+
+    Files of at least `mmap_threshold` bytes are memory mapped (privately, so
+    adding the newline only copies the last page), smaller ones are read into
+    a heap buffer. Either way the file is read once and the tokenizer and the
+    LocationManager line index work on this single copy.
+*/
+class SourceBuffer
+{
+public:
+    static const size_t padding = 64;
+    static const size_t mmap_threshold = 16*1024;
+
+    SourceBuffer() = default;
+    ~SourceBuffer();
+    SourceBuffer(const SourceBuffer &) = delete;
+    SourceBuffer &operator=(const SourceBuffer &) = delete;
+
+    // Returns false if the file cannot be read
+    bool load_file(const std::string &filename);
+    void load_string(const std::string &s);
+
+    // NUL terminated
+    const char *data() const { return buf; }
+    // Of the file, without the added newline
+    size_t size() const { return file_size; }
+    // What the tokenizer sees, including the added newline
+    size_t text_size() const { return text_n; }
+    bool is_mapped() const { return mapped_size > 0; }
+
+    // Sets up the line index of the last file of `lm` (`lm.files.back()`)
+    // like `lm.init_simple()` does from a copy of the contents
+    void init_location_manager(LocationManager &lm) const;
+
+private:
+    char *buf = nullptr;
+    size_t file_size = 0;
+    size_t text_n = 0;
+    size_t mapped_size = 0;
+    std::unique_ptr<char[]> heap;
+
+    void release();
+    char *allocate(size_t size);
+    void finish(size_t size);
+};
+
+} // namespace LCompilers::LPython
+
+#endif // LPYTHON_PARSER_SOURCE_BUFFER_H
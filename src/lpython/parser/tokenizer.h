@@ -9,6 +9,8 @@
 
 namespace LCompilers::LPython {
 
+class NameInterner;
+
 class Tokenizer
 {
 public:
@@ -17,6 +19,7 @@ public:
     unsigned char *cur_line;
     unsigned int line_num;
     unsigned char *string_start;
+    unsigned char *string_end; // One past the last byte of the input
     uint32_t prev_loc; // The previous file ended at this location.
 
     int last_token=-1;
@@ -31,10 +34,16 @@ public:
     char paren_stack[MAX_PAREN_LEVEL];
     size_t parenlevel = 0;
 
+    // If set, TK_NAME tokens are returned interned (NUL terminated)
+    NameInterner *names = nullptr;
+
 public:
     // Set the string to tokenize. The caller must ensure `str` will stay valid
     // as long as `lex` is being called.
     void set_string(const std::string &str, uint32_t prev_loc_);
+    // The same for `size` bytes at `str`; the buffer must be NUL terminated
+    // at or after `str + size`
+    void set_string(const char *str, size_t size, uint32_t prev_loc_);
 
     // Get next token. Token ID is returned as function result, the semantic
     // value is put into `yylval`.
@@ -53,6 +62,10 @@ public:
         s.n = cur-tok;
     }
 
+    // Return the current TK_NAME token as YYSTYPE::Str, interned if `names`
+    // is set
+    void token_name(Allocator &al, Str &s) const;
+
     // Return the current token as YYSTYPE::Str, strips first and last character
     void token_str(Str &s) const
     {
@@ -77,6 +90,9 @@ public:
 
     void record_paren(Location &loc, char c);
 
+    // Throws the error for the current token, which no rule matched
+    [[noreturn]] void token_not_recognized(Location &loc);
+
     void lex_match_or_case(Location &loc, unsigned char *cur,
         bool &is_match_or_case_keyword);
 };
@@ -0,0 +1,171 @@
+#ifndef LPYTHON_PARSER_TOKENIZER_SIMD_H
+#define LPYTHON_PARSER_TOKENIZER_SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/*
+    Fast paths of the tokenizer for the parts of the input that are long runs
+    of "uninteresting" bytes: blanks (indentation), the rest of a comment, the
+    rest of an identifier and the contents of a string. Each function returns
+    a pointer to the first byte at or after `p` that stops the run; the re2c
+    automaton takes over from there.
+
+    `end` points to the NUL that terminates the input, and NUL stops every
+    run. Only whole blocks before `end` are loaded, the tail (shorter than a
+    block) is scanned byte by byte, so nothing outside of the input is read
+    and no padding is needed (e.g. for a std::string).
+
+    AVX2 (32 byte blocks) or SSE2 (16 byte blocks) is used if the compiler
+    targets it, a byte by byte loop otherwise.
+*/
+
+namespace LCompilers::LPython::simd {
+
+inline bool is_blank(unsigned char c) {
+    return c == ' ' || c == '\t' || c == '\v';
+}
+
+inline bool is_name_char(unsigned char c) {
+    return c >= 0x80 || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+        || (c >= '0' && c <= '9') || c == '_';
+}
+
+#if defined(__AVX2__) || defined(__SSE2__)
+
+#if defined(__AVX2__)
+typedef __m256i vec;
+typedef uint32_t vec_mask;
+const size_t vec_size = 32;
+const vec_mask all_bytes = 0xFFFFFFFF;
+inline vec load(const unsigned char *p) { return _mm256_loadu_si256((const vec *)p); }
+inline vec splat(char c) { return _mm256_set1_epi8(c); }
+inline vec eq(vec a, vec b) { return _mm256_cmpeq_epi8(a, b); }
+inline vec gt(vec a, vec b) { return _mm256_cmpgt_epi8(a, b); }
+inline vec vor(vec a, vec b) { return _mm256_or_si256(a, b); }
+inline vec vand(vec a, vec b) { return _mm256_and_si256(a, b); }
+inline vec_mask movemask(vec a) { return (vec_mask)_mm256_movemask_epi8(a); }
+#else
+typedef __m128i vec;
+typedef uint32_t vec_mask;
+const size_t vec_size = 16;
+const vec_mask all_bytes = 0xFFFF;
+inline vec load(const unsigned char *p) { return _mm_loadu_si128((const vec *)p); }
+inline vec splat(char c) { return _mm_set1_epi8(c); }
+inline vec eq(vec a, vec b) { return _mm_cmpeq_epi8(a, b); }
+inline vec gt(vec a, vec b) { return _mm_cmpgt_epi8(a, b); }
+inline vec vor(vec a, vec b) { return _mm_or_si128(a, b); }
+inline vec vand(vec a, vec b) { return _mm_and_si128(a, b); }
+inline vec_mask movemask(vec a) { return (vec_mask)_mm_movemask_epi8(a); }
+#endif
+
+// The comparisons are signed: bytes >= 0x80 are negative and never fall into
+// an ASCII range
+inline vec in_range(vec x, char lo, char hi) {
+    return vand(gt(x, splat(lo - 1)), gt(splat(hi + 1), x));
+}
+
+// Returns the first byte at or after `p` whose bit is set in `stop(block)`,
+// or the start of the tail before `end` that is shorter than a block (only
+// the low `vec_size` bits of the mask are used)
+template <class Stop>
+inline const unsigned char *scan(const unsigned char *p,
+        const unsigned char *end, Stop stop) {
+    while ((size_t)(end - p) >= vec_size) {
+        vec_mask m = stop(load(p)) & all_bytes;
+        if (m != 0) return p + __builtin_ctz(m);
+        p += vec_size;
+    }
+    return p;
+}
+
+#endif
+
+// The SIMD scan stops at the first byte that ends the run or at the tail,
+// the byte by byte loop does the rest (nothing if the run already ended)
+
+inline const unsigned char *skip_blanks(const unsigned char *p,
+        const unsigned char *end) {
+#if defined(__AVX2__) || defined(__SSE2__)
+    p = scan(p, end, [](vec x) -> vec_mask {
+        return ~movemask(vor(vor(eq(x, splat(' ')), eq(x, splat('\t'))),
+            eq(x, splat('\v'))));
+    });
+#else
+    (void)end;
+#endif
+    while (is_blank(*p)) p++;
+    return p;
+}
+
+inline const unsigned char *skip_to_newline(const unsigned char *p,
+        const unsigned char *end) {
+#if defined(__AVX2__) || defined(__SSE2__)
+    p = scan(p, end, [](vec x) -> vec_mask {
+        return movemask(vor(eq(x, splat('\n')), eq(x, splat('\0'))));
+    });
+#else
+    (void)end;
+#endif
+    while (*p != '\n' && *p != '\0') p++;
+    return p;
+}
+
+inline const unsigned char *skip_name_chars(const unsigned char *p,
+        const unsigned char *end) {
+#if defined(__AVX2__) || defined(__SSE2__)
+    p = scan(p, end, [](vec x) -> vec_mask {
+        vec letter = in_range(vor(x, splat(0x20)), 'a', 'z');
+        vec digit = in_range(x, '0', '9');
+        vec non_ascii = gt(splat(0), x);
+        return ~movemask(vor(vor(letter, digit),
+            vor(non_ascii, eq(x, splat('_')))));
+    });
+#else
+    (void)end;
+#endif
+    while (is_name_char(*p)) p++;
+    return p;
+}
+
+inline const unsigned char *skip_string_chars(const unsigned char *p,
+        const unsigned char *end, char quote) {
+#if defined(__AVX2__) || defined(__SSE2__)
+    vec q = splat(quote);
+    p = scan(p, end, [q](vec x) -> vec_mask {
+        return movemask(vor(vor(eq(x, q), eq(x, splat('\\'))),
+            vor(eq(x, splat('\n')), eq(x, splat('\0')))));
+    });
+#else
+    (void)end;
+#endif
+    while (*p != (unsigned char)quote && *p != '\\' && *p != '\n' && *p != '\0') {
+        p++;
+    }
+    return p;
+}
+
+// Skips the rest of a single line string (`string1`, `string2`), `p` points
+// after the opening quote. Returns a pointer after the closing quote, or
+// nullptr if the string is not terminated on this line.
+inline const unsigned char *skip_string(const unsigned char *p,
+        const unsigned char *end, char quote) {
+    for (;;) {
+        p = skip_string_chars(p, end, quote);
+        if (*p == (unsigned char)quote) return p + 1;
+        // An escaped character, which can also be a newline
+        if (*p == '\\' && p[1] != '\0') {
+            p += 2;
+            continue;
+        }
+        return nullptr;
+    }
+}
+
+} // namespace LCompilers::LPython::simd
+
+#endif // LPYTHON_PARSER_TOKENIZER_SIMD_H
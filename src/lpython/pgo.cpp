@@ -0,0 +1,257 @@
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/MDBuilder.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Transforms/Utils/ModuleUtils.h>
+
+#include <libasr/string_utils.h>
+#include <libasr/utils.h>
+#include <lpython/pgo.h>
+
+namespace LCompilers::LPython {
+
+namespace {
+
+    const std::string profile_magic = "LPython profile 1";
+
+    struct FunctionProfile {
+        uint64_t entry = 0;
+        // Number of times each conditional branch was taken / not taken
+        std::vector<std::pair<uint64_t, uint64_t>> branches;
+    };
+
+    bool is_profiled(const llvm::Function &f) {
+        return !f.isDeclaration() && !f.hasAvailableExternallyLinkage();
+    }
+
+    // The conditional branches of `f` in the order they are numbered in the
+    // profile
+    std::vector<llvm::BranchInst*> get_branches(llvm::Function &f) {
+        std::vector<llvm::BranchInst*> branches;
+        for (auto &bb: f) {
+            auto br = llvm::dyn_cast_or_null<llvm::BranchInst>(bb.getTerminator());
+            if (br && br->isConditional()) branches.push_back(br);
+        }
+        return branches;
+    }
+
+    // Writes the counters at exit:
+    //
+    // LPython profile 1
+    // fn <entry count> <number of branches> <function name>
+    // <taken> <not taken> (for each branch)
+    // ...
+    void add_profile_writer(llvm::Module &m, llvm::GlobalVariable *counters,
+            llvm::ArrayType *counters_type,
+            const std::vector<llvm::Function*> &functions,
+            const std::vector<size_t> &n_branches) {
+        llvm::LLVMContext &context = m.getContext();
+        llvm::Type *i32 = llvm::Type::getInt32Ty(context);
+        llvm::Type *i64 = llvm::Type::getInt64Ty(context);
+        llvm::Type *i8_ptr = llvm::PointerType::get(llvm::Type::getInt8Ty(context), 0);
+        llvm::FunctionCallee getenv = m.getOrInsertFunction("getenv",
+            llvm::FunctionType::get(i8_ptr, {i8_ptr}, false));
+        llvm::FunctionCallee fopen = m.getOrInsertFunction("fopen",
+            llvm::FunctionType::get(i8_ptr, {i8_ptr, i8_ptr}, false));
+        llvm::FunctionCallee fprintf = m.getOrInsertFunction("fprintf",
+            llvm::FunctionType::get(i32, {i8_ptr, i8_ptr}, true));
+        llvm::FunctionCallee fclose = m.getOrInsertFunction("fclose",
+            llvm::FunctionType::get(i32, {i8_ptr}, false));
+
+        llvm::Function *writer = llvm::Function::Create(
+            llvm::FunctionType::get(llvm::Type::getVoidTy(context), false),
+            llvm::GlobalValue::InternalLinkage, "__lpython_prof_write", m);
+        llvm::BasicBlock *entry = llvm::BasicBlock::Create(context, "entry", writer);
+        llvm::BasicBlock *write = llvm::BasicBlock::Create(context, "write", writer);
+        llvm::BasicBlock *done = llvm::BasicBlock::Create(context, "done", writer);
+        llvm::IRBuilder<> builder(entry);
+        llvm::Value *env = builder.CreateCall(getenv,
+            {builder.CreateGlobalStringPtr("LPYTHON_PROFILE_FILE")});
+        llvm::Value *filename = builder.CreateSelect(
+            builder.CreateIsNull(env),
+            builder.CreateGlobalStringPtr("lpython.prof"), env);
+        llvm::Value *file = builder.CreateCall(fopen,
+            {filename, builder.CreateGlobalStringPtr("a")});
+        builder.CreateCondBr(builder.CreateIsNull(file), done, write);
+
+        builder.SetInsertPoint(write);
+        builder.CreateCall(fprintf, {file,
+            builder.CreateGlobalStringPtr(profile_magic + "\n")});
+        llvm::Value *fn_format = builder.CreateGlobalStringPtr("fn %llu %llu %s\n");
+        llvm::Value *branch_format = builder.CreateGlobalStringPtr("%llu %llu\n");
+        auto load_counter = [&](size_t i) {
+            return builder.CreateLoad(i64, builder.CreateConstInBoundsGEP2_64(
+                counters_type, counters, 0, i));
+        };
+        size_t slot = 0;
+        for (size_t i = 0; i < functions.size(); i++) {
+            builder.CreateCall(fprintf, {file, fn_format, load_counter(slot),
+                llvm::ConstantInt::get(i64, n_branches[i]),
+                builder.CreateGlobalStringPtr(functions[i]->getName())});
+            for (size_t j = 0; j < n_branches[i]; j++) {
+                builder.CreateCall(fprintf, {file, branch_format,
+                    load_counter(slot + 1 + 2*j), load_counter(slot + 2 + 2*j)});
+            }
+            slot += 1 + 2*n_branches[i];
+        }
+        builder.CreateCall(fclose, {file});
+        builder.CreateBr(done);
+
+        builder.SetInsertPoint(done);
+        builder.CreateRetVoid();
+        llvm::appendToGlobalDtors(m, writer, 0);
+    }
+
+    bool read_profile(const std::string &filename,
+            std::map<std::string, std::map<size_t, FunctionProfile>> &profiles,
+            std::string &error) {
+        std::string s;
+        if (!read_file(filename, s)) {
+            error = "cannot read the profile '" + filename + "'";
+            return false;
+        }
+        std::istringstream in(s);
+        std::string line;
+        FunctionProfile *current = nullptr;
+        size_t branch = 0;
+        while (std::getline(in, line)) {
+            std::istringstream l(line);
+            if (line == profile_magic) {
+                current = nullptr;
+            } else if (startswith(line, "fn ")) {
+                std::string tag, name;
+                uint64_t entry;
+                size_t n_branches;
+                if (!(l >> tag >> entry >> n_branches >> name)) break;
+                // Runs of the same build are summed
+                current = &profiles[name][n_branches];
+                current->entry += entry;
+                current->branches.resize(n_branches);
+                branch = 0;
+            } else {
+                uint64_t taken, not_taken;
+                if (!current || branch >= current->branches.size()
+                        || !(l >> taken >> not_taken)) {
+                    break;
+                }
+                current->branches[branch].first += taken;
+                current->branches[branch].second += not_taken;
+                branch++;
+            }
+        }
+        if (in.eof()) return true;
+        error = "the profile '" + filename + "' is malformed";
+        return false;
+    }
+
+} // namespace
+
+void instrument_module(llvm::Module &m) {
+    llvm::LLVMContext &context = m.getContext();
+    llvm::Type *i64 = llvm::Type::getInt64Ty(context);
+    std::vector<llvm::Function*> functions;
+    std::vector<std::vector<llvm::BranchInst*>> branches;
+    std::vector<size_t> n_branches;
+    size_t n_counters = 0;
+    for (auto &f: m) {
+        if (!is_profiled(f)) continue;
+        functions.push_back(&f);
+        branches.push_back(get_branches(f));
+        n_branches.push_back(branches.back().size());
+        n_counters += 1 + 2*branches.back().size();
+    }
+    if (n_counters == 0) return;
+
+    // One counter for the entry of each function, followed by two for
+    // every conditional branch in it
+    llvm::ArrayType *counters_type = llvm::ArrayType::get(i64, n_counters);
+    llvm::GlobalVariable *counters = new llvm::GlobalVariable(m, counters_type,
+        false, llvm::GlobalValue::InternalLinkage,
+        llvm::ConstantAggregateZero::get(counters_type), "__lpython_prof_counters");
+    llvm::IRBuilder<> builder(context);
+    auto counter = [&](size_t i) {
+        return builder.CreateConstInBoundsGEP2_64(counters_type, counters, 0, i);
+    };
+    auto increment = [&](llvm::Value *ptr) {
+        llvm::Value *value = builder.CreateLoad(i64, ptr);
+        builder.CreateStore(builder.CreateAdd(value,
+            llvm::ConstantInt::get(i64, 1)), ptr);
+    };
+    size_t slot = 0;
+    for (size_t i = 0; i < functions.size(); i++) {
+        llvm::BasicBlock &entry = functions[i]->getEntryBlock();
+        auto it = entry.getFirstInsertionPt();
+        while (llvm::isa<llvm::AllocaInst>(*it)) it++;
+        builder.SetInsertPoint(&*it);
+        increment(counter(slot));
+        for (size_t j = 0; j < branches[i].size(); j++) {
+            llvm::BranchInst *br = branches[i][j];
+            builder.SetInsertPoint(br);
+            increment(builder.CreateSelect(br->getCondition(),
+                counter(slot + 1 + 2*j), counter(slot + 2 + 2*j)));
+        }
+        slot += 1 + 2*branches[i].size();
+    }
+    add_profile_writer(m, counters, counters_type, functions, n_branches);
+}
+
+bool apply_profile(llvm::Module &m, const std::string &filename,
+        std::string &error) {
+    std::map<std::string, std::map<size_t, FunctionProfile>> profiles;
+    if (!read_profile(filename, profiles, error)) return false;
+    uint64_t max_entry = 0;
+    for (auto &p: profiles) {
+        uint64_t entry = 0;
+        for (auto &q: p.second) entry += q.second.entry;
+        max_entry = std::max(max_entry, entry);
+    }
+
+    llvm::MDBuilder md_builder(m.getContext());
+    for (auto &f: m) {
+        if (!is_profiled(f)) continue;
+        auto it = profiles.find(f.getName().str());
+        // Not in the profile, e.g. a new function
+        if (it == profiles.end()) continue;
+        std::vector<llvm::BranchInst*> branches = get_branches(f);
+        uint64_t entry = 0;
+        const FunctionProfile *profile = nullptr;
+        for (auto &q: it->second) {
+            entry += q.second.entry;
+            // The branches can only be matched if the function kept the
+            // same structure
+            if (q.first == branches.size()) profile = &q.second;
+        }
+        f.setEntryCount(entry);
+        if (entry == 0) {
+            f.addFnAttr(llvm::Attribute::Cold);
+        } else if (entry >= max_entry / 10) {
+#if LLVM_VERSION_MAJOR >= 12
+            f.addFnAttr(llvm::Attribute::Hot);
+#endif
+            if (!f.hasFnAttribute(llvm::Attribute::NoInline)) {
+                f.addFnAttr(llvm::Attribute::InlineHint);
+            }
+        }
+        if (!profile) continue;
+        for (size_t i = 0; i < branches.size(); i++) {
+            uint64_t taken = profile->branches[i].first;
+            uint64_t not_taken = profile->branches[i].second;
+            if (taken == 0 && not_taken == 0) continue;
+            // The weights are 32 bit
+            uint64_t scale = std::max(taken, not_taken)
+                / std::numeric_limits<uint32_t>::max() + 1;
+            branches[i]->setMetadata(llvm::LLVMContext::MD_prof,
+                md_builder.createBranchWeights(taken / scale, not_taken / scale));
+        }
+    }
+    return true;
+}
+
+} // namespace LCompilers::LPython
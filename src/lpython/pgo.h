@@ -0,0 +1,39 @@
+#ifndef LPYTHON_PGO_H
+#define LPYTHON_PGO_H
+
+#include <string>
+
+namespace llvm {
+    class Module;
+}
+
+namespace LCompilers::LPython {
+
+    /*
+        Profile guided optimization (`--profile-generate`, `--profile-use`).
+
+        `instrument_module` adds a counter to the entry of every function and
+        to both edges of every conditional branch. The executable writes the
+        counters at exit to the file given by the `LPYTHON_PROFILE_FILE`
+        environment variable (`lpython.prof` by default). Every run appends
+        to the file and the counts of all the runs are summed when it is
+        used.
+
+        The profile is keyed by the function names, which asr_to_llvm derives
+        from the Python names, and the branches are numbered within each
+        function. `apply_profile` attaches the branch weights to every
+        function whose number of branches did not change and marks the
+        functions that were never called as cold and the most frequently
+        called ones as hot.
+
+        Both must be called on the module before it is optimized.
+    */
+    void instrument_module(llvm::Module &m);
+
+    // Returns false (and sets `error`) if the profile cannot be read
+    bool apply_profile(llvm::Module &m, const std::string &filename,
+        std::string &error);
+
+} // namespace LCompilers::LPython
+
+#endif // LPYTHON_PGO_H
@@ -1,4 +1,6 @@
+#include <chrono>
 #include <iostream>
+#include <set>
 #include <fstream>
 #include <string>
 
@@ -20,6 +22,13 @@
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Type.h>
 #include <llvm/IR/DataLayout.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IRReader/IRReader.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/Support/SourceMgr.h>
+#include <lpython/multiversion.h>
+#include <lpython/opt_remarks.h>
+#include <lpython/pgo.h>
 #else
 namespace LCompilers {
     class LLVMEvaluator {};
@@ -434,7 +443,104 @@ Result<std::unique_ptr<LLVMModule>> PythonCompiler::get_llvm2(
 }
 
 
+#ifdef HAVE_LFORTRAN_LLVM
+namespace {
+
+    // Runtime functions that use (directly or through an internal helper)
+    // mutable internal state, e.g. the state of the random number generator.
+    // These must not be duplicated in the user's module.
+    std::set<llvm::Function*> get_stateful_functions(llvm::Module &rt) {
+        std::set<llvm::Function*> stateful;
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (llvm::Function &f: rt) {
+                if (f.isDeclaration() || stateful.count(&f)) continue;
+                for (llvm::BasicBlock &bb: f) {
+                    for (llvm::Instruction &inst: bb) {
+                        for (llvm::Value *op: inst.operands()) {
+                            llvm::Value *v = op->stripPointerCasts();
+                            if (auto g = llvm::dyn_cast<llvm::GlobalVariable>(v)) {
+                                if (g->hasLocalLinkage() && !g->isConstant()) {
+                                    stateful.insert(&f);
+                                }
+                            } else if (auto callee = llvm::dyn_cast<llvm::Function>(v)) {
+                                if (callee->hasLocalLinkage() && stateful.count(callee)) {
+                                    stateful.insert(&f);
+                                }
+                            }
+                        }
+                    }
+                }
+                if (stateful.count(&f)) changed = true;
+            }
+        }
+        return stateful;
+    }
+
+    /*
+        Links the definitions of the runtime library functions used by `m`
+        from the runtime bitcode, so that the optimizer can inline and
+        vectorize them. The functions are linked as `available_externally`:
+        the bodies are only used for optimization and the calls that remain
+        still resolve to the runtime library the executable is linked with.
+    */
+    bool link_runtime_bitcode(llvm::Module &m, const std::string &filename,
+            std::string &error) {
+        llvm::SMDiagnostic err;
+        std::unique_ptr<llvm::Module> rt = llvm::parseIRFile(filename, err,
+            m.getContext());
+        if (!rt) {
+            error = err.getMessage().str();
+            return false;
+        }
+        rt->setDataLayout(m.getDataLayout());
+        rt->setTargetTriple(m.getTargetTriple());
+        std::set<llvm::Function*> stateful = get_stateful_functions(*rt);
+        for (llvm::Function &f: *rt) {
+            if (f.isDeclaration()) continue;
+            // Use the same CPU and features as the user's code
+            f.removeFnAttr("target-cpu");
+            f.removeFnAttr("target-features");
+            if (f.hasLocalLinkage()) continue;
+            if (stateful.count(&f)) {
+                f.deleteBody();
+            } else {
+                f.setLinkage(llvm::GlobalValue::AvailableExternallyLinkage);
+            }
+        }
+        for (llvm::GlobalVariable &g: rt->globals()) {
+            // Exported variables stay defined in the runtime library only
+            if (!g.isDeclaration() && !g.hasLocalLinkage()) {
+                g.setInitializer(nullptr);
+                g.setLinkage(llvm::GlobalValue::ExternalLinkage);
+                g.setComdat(nullptr);
+            }
+        }
+        if (llvm::Linker::linkModules(m, std::move(rt),
+                llvm::Linker::Flags::LinkOnlyNeeded)) {
+            error = "failed to link the runtime bitcode " + filename;
+            return false;
+        }
+        return true;
+    }
+
+} // namespace
+#endif
+
 Result<std::unique_ptr<LLVMModule>> PythonCompiler::get_llvm3(
+    ASR::TranslationUnit_t &asr, LCompilers::PassManager& lpm,
+    diag::Diagnostics &diagnostics, LCompilers::LocationManager &lm, const std::string &infile)
+{
+    Result<std::unique_ptr<LLVMModule>> res = get_llvm_ir(asr, lpm,
+        diagnostics, lm, infile);
+    if (!res.ok) {
+        return res.error;
+    }
+    return optimize_llvm(std::move(res.result), asr, diagnostics, lm, infile);
+}
+
+Result<std::unique_ptr<LLVMModule>> PythonCompiler::get_llvm_ir(
 #ifdef HAVE_LFORTRAN_LLVM
     ASR::TranslationUnit_t &asr, LCompilers::PassManager& lpm,
     diag::Diagnostics &diagnostics, LCompilers::LocationManager &lm, const std::string &infile
@@ -460,19 +566,105 @@ Result<std::unique_ptr<LLVMModule>> PythonCompiler::get_llvm3(
     }
     // ASR -> LLVM
     std::unique_ptr<LCompilers::LLVMModule> m;
+    if (report) {
+        report->asr_nodes.push_back(std::make_pair("before the ASR passes",
+            LPython::count_asr_nodes(asr)));
+    }
+    std::unique_ptr<LPython::ASRRemarkCollector> remark_collector;
+    if (opt_remarks) {
+        remark_collector = std::make_unique<LPython::ASRRemarkCollector>(asr,
+            *opt_remarks, compiler_options.po.fast);
+    }
+    // asr_to_llvm applies the ASR passes before it generates the LLVM IR
+    auto asr_to_llvm_start = std::chrono::high_resolution_clock::now();
     Result<std::unique_ptr<LCompilers::LLVMModule>> res
         = asr_to_llvm(asr, diagnostics,
             e->get_context(), al, lpm, compiler_options,
             run_fn, global_underscore_name, infile, lm);
+    auto asr_to_llvm_end = std::chrono::high_resolution_clock::now();
+    if (remark_collector) {
+        remark_collector->passes_applied();
+    }
+    if (report) {
+        report->asr_nodes.push_back(std::make_pair("after the ASR passes",
+            LPython::count_asr_nodes(asr)));
+        report->times.push_back(std::make_pair("ASR passes + LLVM IR generation",
+            std::chrono::duration<double, std::milli>(asr_to_llvm_end
+                - asr_to_llvm_start).count()));
+        report->memory.push_back(LPython::get_memory_usage(
+            "ASR passes + LLVM IR generation", al));
+    }
     if (res.ok) {
         m = std::move(res.result);
     } else {
         LCOMPILERS_ASSERT(diagnostics.has_error())
         return res.error;
     }
+    return m;
+#else
+    throw LCompilersException("LLVM is not enabled");
+#endif
+}
+
+Result<std::unique_ptr<LLVMModule>> PythonCompiler::optimize_llvm(
+#ifdef HAVE_LFORTRAN_LLVM
+    std::unique_ptr<LLVMModule> m, ASR::TranslationUnit_t &asr,
+    diag::Diagnostics &diagnostics, LCompilers::LocationManager &lm, const std::string &infile
+#else
+    std::unique_ptr<LLVMModule> /*m*/, ASR::TranslationUnit_t &/*asr*/,
+    diag::Diagnostics &/*diagnostics*/, LCompilers::LocationManager & /*lm*/, const std::string &/*infile*/
+#endif
+    )
+{
+#ifdef HAVE_LFORTRAN_LLVM
+    if (profile_generate) {
+        LPython::instrument_module(*m->m_m);
+    } else if (!profile_use.empty()) {
+        std::string error;
+        if (!LPython::apply_profile(*m->m_m, profile_use, error)) {
+            diagnostics.add(diag::Diagnostic(error, diag::Level::Error,
+                diag::Stage::CodeGen, {}));
+            Error err;
+            return err;
+        }
+    }
+
+    if (!multiversion.empty()) {
+        std::string error;
+        std::string target = compiler_options.target.empty()
+            ? LLVMEvaluator::get_default_target_triple() : compiler_options.target;
+        if (!LPython::multiversion_module(*m->m_m, multiversion, target, error)) {
+            diagnostics.add(diag::Diagnostic(error, diag::Level::Error,
+                diag::Stage::CodeGen, {}));
+            Error err;
+            return err;
+        }
+    }
 
     if (compiler_options.po.fast) {
-        e->opt(*m->m_m);
+        auto opt_start = std::chrono::high_resolution_clock::now();
+        if (!runtime_bitcode.empty()) {
+            std::string error;
+            if (!link_runtime_bitcode(*m->m_m, runtime_bitcode, error)
+                    && compiler_options.po.verbose) {
+                std::cerr << "Runtime bitcode not used: " << error << std::endl;
+            }
+        }
+        {
+            std::unique_ptr<LPython::LLVMRemarkCollector> llvm_remarks;
+            if (opt_remarks) {
+                llvm_remarks = std::make_unique<LPython::LLVMRemarkCollector>(
+                    m->m_m->getContext(), asr, lm, infile, *opt_remarks);
+            }
+            e->opt(*m->m_m);
+        }
+        auto opt_end = std::chrono::high_resolution_clock::now();
+        if (report) {
+            report->times.push_back(std::make_pair("LLVM optimization",
+                std::chrono::duration<double, std::milli>(opt_end - opt_start).count()));
+            report->memory.push_back(LPython::get_memory_usage(
+                "LLVM optimization", al));
+        }
     }
 
     return m;
@@ -9,6 +9,7 @@
 #include <libasr/asr.h>
 #include <lpython/python_ast.h>
 #include <lpython/utils.h>
+#include <lpython/time_report.h>
 #include <libasr/config.h>
 #include <libasr/diagnostics.h>
 #include <libasr/pass/pass_manager.h>
@@ -22,6 +23,10 @@ namespace LCompilers {
 class LLVMModule;
 class LLVMEvaluator;
 
+namespace LPython {
+    struct OptRemarks;
+}
+
 /*
    PythonCompiler is the main class to access the Python compiler.
 
@@ -41,6 +46,29 @@ public:
     PythonCompiler(CompilerOptions compiler_options);
     ~PythonCompiler();
 
+    // If set, get_llvm_ir() adds the combined time of the ASR passes and
+    // the LLVM code generation (asr_to_llvm runs both, the PassManager does
+    // not report the individual passes) with the ASR node counts before and
+    // after, and optimize_llvm() the time of the LLVM optimizations
+    LPython::CompilationReport *report = nullptr;
+
+    // If set, get_llvm3() adds the decisions of the ASR and LLVM
+    // optimization passes to it, see lpython/opt_remarks.h
+    LPython::OptRemarks *opt_remarks = nullptr;
+
+    // If set, get_llvm3() links the runtime library functions used by the
+    // module from this LLVM bitcode file before the `--fast` optimizations
+    std::string runtime_bitcode;
+
+    // Profile guided optimization, see lpython/pgo.h: get_llvm3() either
+    // instruments the module or applies the profile in `profile_use` to it
+    bool profile_generate = false;
+    std::string profile_use;
+
+    // ISA levels (e.g. "avx2", "avx512") for which get_llvm3() clones the
+    // functions with array loops, see lpython/multiversion.h
+    std::vector<std::string> multiversion;
+
     struct EvalResult {
         enum {
             integer1,
@@ -119,6 +147,18 @@ public:
         LCompilers::PassManager& lpm, diag::Diagnostics &diagnostics, LCompilers::LocationManager& lm,
         const std::string &infile);
 
+    // get_llvm3() in two steps: get_llvm_ir() applies the ASR passes and
+    // generates the LLVM IR, optimize_llvm() applies the profile, the
+    // multiversioning and the `--fast` optimizations. The latter only
+    // modifies the LLVM module, so it can run for several files at once.
+    Result<std::unique_ptr<LLVMModule>> get_llvm_ir(ASR::TranslationUnit_t &asr,
+        LCompilers::PassManager& lpm, diag::Diagnostics &diagnostics, LCompilers::LocationManager& lm,
+        const std::string &infile);
+
+    Result<std::unique_ptr<LLVMModule>> optimize_llvm(std::unique_ptr<LLVMModule> m,
+        ASR::TranslationUnit_t &asr, diag::Diagnostics &diagnostics,
+        LCompilers::LocationManager& lm, const std::string &infile);
+
     Result<std::string> get_asm(const std::string &code,
             LocationManager &lm,
             LCompilers::PassManager& pass_manager,
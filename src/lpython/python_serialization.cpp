@@ -8,6 +8,31 @@
 
 namespace LCompilers::LPython {
 
+class ASTSerializationVisitor :
+#ifdef WITH_LFORTRAN_BINARY_MODFILES
+    public BinaryWriter,
+#else
+    public TextWriter,
+#endif
+    public AST::SerializationBaseVisitor<ASTSerializationVisitor>
+{
+public:
+    void write_bool(bool b) {
+        if (b) {
+            write_int8(1);
+        } else {
+            write_int8(0);
+        }
+    }
+};
+
+std::string serialize_ast(const AST::ast_t &ast) {
+    ASTSerializationVisitor v;
+    v.write_int8(ast.type);
+    v.visit_ast(ast);
+    return v.get_str();
+}
+
 class ASTDeserializationVisitor :
 #ifdef WITH_LFORTRAN_BINARY_MODFILES
     public BinaryReader,
@@ -17,13 +42,14 @@ class ASTDeserializationVisitor :
     public AST::DeserializationBaseVisitor<ASTDeserializationVisitor>
 {
 public:
-    ASTDeserializationVisitor(Allocator &al, const std::string &s) :
+    ASTDeserializationVisitor(Allocator &al, const std::string &s,
+            uint32_t offset) :
 #ifdef WITH_LFORTRAN_BINARY_MODFILES
         BinaryReader(s),
 #else
         TextReader(s),
 #endif
-        DeserializationBaseVisitor(al, true, 0) {}
+        DeserializationBaseVisitor(al, true, offset) {}
 
     bool read_bool() {
         uint8_t b = read_int8();
@@ -39,8 +65,9 @@ public:
     }
 };
 
-AST::ast_t* deserialize_ast(Allocator &al, const std::string &s) {
-    ASTDeserializationVisitor v(al, s);
+AST::ast_t* deserialize_ast(Allocator &al, const std::string &s,
+        uint32_t offset) {
+    ASTDeserializationVisitor v(al, s, offset);
     return v.deserialize_node();
 }
 
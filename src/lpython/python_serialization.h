@@ -6,7 +6,11 @@
 
 namespace LCompilers::LPython {
 
-    AST::ast_t* deserialize_ast(Allocator &al, const std::string &s);
+    std::string serialize_ast(const AST::ast_t &ast);
+    // `offset` is added to all the locations, e.g. to load an AST parsed
+    // with a different `prev_loc`
+    AST::ast_t* deserialize_ast(Allocator &al, const std::string &s,
+        uint32_t offset=0);
 
 } // namespace LCompilers::LPython
 
@@ -1,7 +1,9 @@
+#include <atomic>
 #include <fstream>
 #include <iostream>
 #include <map>
 #include <set>
+#include <unordered_map>
 #include <memory>
 #include <string>
 #include <cmath>
@@ -29,16 +31,32 @@
 #include <lpython/python_ast.h>
 #include <lpython/semantics/python_ast_to_asr.h>
 #include <lpython/utils.h>
+#include <lpython/bigint.h>
 #include <lpython/semantics/semantic_exception.h>
 #include <lpython/python_serialization.h>
+#include <lpython/asr_cache.h>
 #include <lpython/semantics/python_comptime_eval.h>
 #include <lpython/semantics/python_attribute_eval.h>
 #include <lpython/semantics/python_intrinsic_eval.h>
+#include <lpython/semantics/python_function_eval.h>
+#include <lpython/semantics/static_map.h>
 #include <lpython/parser/parser.h>
 #include <libasr/serialization.h>
 
 namespace LCompilers::LPython {
 
+namespace {
+    std::atomic<size_t> overload_cache_hits{0};
+    std::atomic<size_t> overload_cache_misses{0};
+}
+
+OverloadCacheStats get_overload_cache_stats() {
+    OverloadCacheStats stats;
+    stats.hits = overload_cache_hits;
+    stats.misses = overload_cache_misses;
+    return stats;
+}
+
 int save_pyc_files(const ASR::TranslationUnit_t &u,
     std::string infile, LocationManager& lm) {
     diag::Diagnostics diagnostics;
@@ -122,15 +140,19 @@ ASR::TranslationUnit_t* compile_module_till_asr(
         const Location &loc, diag::Diagnostics &diagnostics, LocationManager &lm,
         const std::function<void (const std::string &, const Location &)> err,
         bool allow_implicit_casting) {
+    // Shared by the LocationManager and the parser
+    SourceBuffer source;
     {
         LocationManager::FileLocations fl;
         fl.in_filename = infile;
         lm.files.push_back(fl);
-        std::string input = read_file_ok(infile);
-        lm.file_ends.push_back(lm.file_ends.back() + input.size());
-        lm.init_simple(input);
+        if (!source.load_file(infile)) {
+            err("The file '" + infile + "' cannot be read", loc);
+        }
+        lm.file_ends.push_back(lm.file_ends.back() + source.size());
+        source.init_location_manager(lm);
     }
-    Result<AST::ast_t*> r = parse_python_file(al, rl_path[0], infile,
+    Result<AST::ast_t*> r = parse_python_file(al, rl_path[0], source,
         diagnostics, lm.file_ends.end()[-2], false);
     if (!r.ok) {
         err("The file '" + infile + "' failed to parse", loc);
@@ -143,10 +165,8 @@ ASR::TranslationUnit_t* compile_module_till_asr(
     compiler_options.symtab_only = false;
     Result<ASR::TranslationUnit_t*> r2 = python_ast_to_asr(al, lm, symtab, *ast,
         diagnostics, compiler_options, false, module_name, infile, allow_implicit_casting);
-    // TODO: Uncomment once a check is added for ensuring
-    // that module.py file hasn't changed between
-    // builds.
-    // save_pyc_files(*r2.result, infile + "c");
+    // The module is stored in the ASR cache (if enabled) by `load_module`,
+    // which knows the dependencies to check before the entry can be reused
     if (!r2.ok) {
         LCOMPILERS_ASSERT(diagnostics.has_error())
         return nullptr; // Error
@@ -171,6 +191,113 @@ void fill_module_dependencies(SymbolTable* symtab, SetChar& mod_deps,
     }
 }
 
+std::vector<std::string> get_module_dependencies(ASR::Module_t* mod,
+        Allocator& al) {
+    SetChar mod_deps;
+    mod_deps.reserve(al, 1);
+    fill_module_dependencies(mod->m_symtab, mod_deps, al);
+    std::vector<std::string> deps;
+    for (size_t i = 0; i < mod_deps.size(); i++) {
+        if (std::string(mod_deps[i]) != mod->m_name) {
+            deps.push_back(mod_deps[i]);
+        }
+    }
+    return deps;
+}
+
+ASR::Module_t* load_module(Allocator &al, SymbolTable *symtab,
+                            const std::string &module_name,
+                            const Location &loc, diag::Diagnostics &diagnostics,
+                            LocationManager &lm, bool intrinsic,
+                            std::vector<std::string> &rl_path,
+                            bool &lpython, bool& enum_py, bool& copy, bool& sympy,
+                            const std::function<void (const std::string &, const Location &)> err,
+                            bool allow_implicit_casting);
+
+/*
+    Loads the module `mod1_name` from the ASR cache into `symtab`.
+    Returns false (without touching `symtab`) if there is no up to date
+    entry for it.
+*/
+bool load_module_from_asr_cache(Allocator &al, SymbolTable *symtab,
+        const std::string &module_name, const std::string &mod1_name,
+        const std::string &infile, const std::string &input, uint64_t key,
+        const Location &loc, diag::Diagnostics &diagnostics, LocationManager &lm,
+        const std::function<void (const std::string &, const Location &)> err,
+        bool allow_implicit_casting) {
+    ASRCacheEntry entry;
+    if (!load_asr_cache_entry(mod1_name, infile, key, input, entry)) {
+        return false;
+    }
+    ASR::TranslationUnit_t* mod1 = nullptr;
+    try {
+        Result<ASR::TranslationUnit_t*> r = load_pycfile(al, entry.asr, false, lm);
+        if (!r.ok) return false;
+        mod1 = r.result;
+    } catch (const LCompilersException &) {
+        // Written by an incompatible compiler, recompile from the source
+        return false;
+    }
+    ASR::symbol_t* mod1_sym = mod1->m_symtab->get_symbol(mod1_name);
+    if (!mod1_sym || !ASR::is_a<ASR::Module_t>(*mod1_sym)) {
+        return false;
+    }
+
+    // The dependencies must be in the symbol table before the external
+    // symbols of this module can be resolved
+    for (auto &dep: entry.dependencies) {
+        if (symtab->get_symbol(dep.name) != nullptr) continue;
+        std::vector<std::string> dep_path = {
+            dep.path.substr(0, dep.path.find_last_of("/\\"))};
+        bool dep_lpython, dep_enum_py, dep_copy, dep_sympy;
+        load_module(al, symtab, dep.import_name, loc, diagnostics, lm,
+            dep.intrinsic, dep_path, dep_lpython, dep_enum_py, dep_copy,
+            dep_sympy, err, allow_implicit_casting);
+    }
+
+    ASR::Module_t* mod1_mod = ASR::down_cast<ASR::Module_t>(mod1_sym);
+    symtab->add_symbol(mod1_name, mod1_sym);
+    mod1_mod->m_symtab->parent = symtab;
+    fix_external_symbols(*mod1, *symtab);
+    register_asr_cache_module({mod1_name, module_name, infile,
+        (bool)mod1_mod->m_intrinsic, fnv1a_hash(input)},
+        get_module_dependencies(mod1_mod, al));
+    return true;
+}
+
+/*
+    Stores the freshly compiled module `mod1_mod` in the ASR cache.
+*/
+void save_module_to_asr_cache(Allocator &al, SymbolTable *symtab,
+        ASR::Module_t* mod1_mod, const std::string &module_name,
+        const std::string &infile, const std::string &input, uint64_t key,
+        bool intrinsic, const Location &loc, LocationManager &lm) {
+    std::string mod1_name = mod1_mod->m_name;
+    std::vector<std::string> deps = get_module_dependencies(mod1_mod, al);
+    register_asr_cache_module({mod1_name, module_name, infile, intrinsic,
+        fnv1a_hash(input)}, deps);
+    if (!is_asr_cache_enabled()) return;
+
+    ASRCacheEntry entry;
+    if (!collect_asr_cache_dependencies(mod1_name, deps, entry.dependencies)) {
+        return;
+    }
+    for (auto &dep: entry.dependencies) {
+        ASR::symbol_t* dep_sym = symtab->get_symbol(dep.name);
+        if (dep_sym && ASR::is_a<ASR::Module_t>(*dep_sym)) {
+            dep.intrinsic = ASR::down_cast<ASR::Module_t>(dep_sym)->m_intrinsic;
+        }
+    }
+    // Only this module is stored, the dependencies get their own entries
+    SymbolTable* cache_symtab = al.make_new<SymbolTable>(nullptr);
+    cache_symtab->add_symbol(mod1_name, (ASR::symbol_t*)mod1_mod);
+    ASR::TranslationUnit_t* tu = ASR::down_cast2<ASR::TranslationUnit_t>(
+        ASR::make_TranslationUnit_t(al, loc, cache_symtab, nullptr, 0));
+    entry.source = input;
+    entry.asr = save_pycfile(*tu, lm);
+    save_asr_cache_entry(mod1_name, infile, key, entry);
+}
+
 ASR::Module_t* load_module(Allocator &al, SymbolTable *symtab,
                             const std::string &module_name,
                             const Location &loc, diag::Diagnostics &diagnostics,
@@ -234,13 +361,6 @@ ASR::Module_t* load_module(Allocator &al, SymbolTable *symtab,
     if (lpython) return nullptr;
 
     if( compile_module ) {
-        diagnostics.add(diag::Diagnostic(
-            "The module '" + module_name + "' located in " + infile +" cannot be loaded",
-            diag::Level::Warning, diag::Stage::Semantic, {
-                diag::Label("imported here", {loc})
-            })
-        );
-
         if (module_name == "__init__") {
             std::string module_dir_name = infile.substr(0, infile.find_last_of('/'));
             // assign module directory name
@@ -248,6 +368,23 @@ ASR::Module_t* load_module(Allocator &al, SymbolTable *symtab,
         } else {
             mod1_name = module_name;
         }
+        uint64_t cache_key = get_asr_cache_key(mod1_name, infile, input,
+            allow_implicit_casting);
+        if (load_module_from_asr_cache(al, symtab, module_name, mod1_name,
+                infile, input, cache_key, loc, diagnostics, lm, err,
+                allow_implicit_casting)) {
+            compile_module = false;
+        }
+    }
+
+    if( compile_module ) {
+        diagnostics.add(diag::Diagnostic(
+            "The module '" + module_name + "' located in " + infile +" cannot be loaded",
+            diag::Level::Warning, diag::Stage::Semantic, {
+                diag::Label("imported here", {loc})
+            })
+        );
+
         mod1 = compile_module_till_asr(al, symtab, mod1_name, rl_path, infile, loc, diagnostics,
             lm, err, allow_implicit_casting);
         if (mod1 == nullptr) {
@@ -255,6 +392,13 @@ ASR::Module_t* load_module(Allocator &al, SymbolTable *symtab,
         } else {
             diagnostics.diagnostics.pop_back();
         }
+        ASR::symbol_t* mod1_sym = symtab->get_symbol(mod1_name);
+        if (mod1_sym && ASR::is_a<ASR::Module_t>(*mod1_sym)) {
+            save_module_to_asr_cache(al, symtab,
+                ASR::down_cast<ASR::Module_t>(mod1_sym), module_name, infile,
+                input, get_asr_cache_key(mod1_name, infile, input,
+                allow_implicit_casting), intrinsic, loc, lm);
+        }
     }
 
     ASR::symbol_t* mod1_sym = symtab->resolve_symbol(mod1_name);
@@ -357,10 +501,40 @@ public:
     SetChar dependencies;
     bool allow_implicit_casting;
     // Stores the name of imported functions and the modules they are imported from
-    std::map<std::string, std::string> imported_functions;
+    std::unordered_map<std::string, std::string> imported_functions;
+    /*
+        The parser interns identifiers, so the equal names of a module share
+        one `char*` in the AST, while SymbolTable looks names up by
+        std::string. `name_str` converts each unique name once at that
+        boundary; the AST outlives the visitor, so the keys stay valid.
+    */
+    std::unordered_map<const char*, std::string> name_strings;
+
+    const std::string &name_str(const char *id) {
+        auto it = name_strings.find(id);
+        if (it == name_strings.end()) {
+            it = name_strings.emplace(id, id).first;
+        }
+        return it->second;
+    }
+    /*
+        The overload selected by `select_generic_procedure` for the types of
+        the positional arguments of a call to a GenericProcedure, so that the
+        call sites of heavily overloaded functions (abs, pow, round, ... of
+        lpython_builtin) match the arguments against every overload only once
+        per argument signature. The key contains the GenericProcedure and its
+        list of overloads, see `overload_cache_key`.
+    */
+    std::unordered_map<std::string, int> overload_cache;
+    // Evaluate the calls of user defined functions with compile time
+    // arguments, see PythonFunctionEvaluator
+    bool comptime_eval_functions = false;
+    // The fuel left for these evaluations in this compilation (imported
+    // modules are compiled without them)
+    size_t comptime_eval_budget = PythonFunctionEvaluator::default_budget;
     bool using_args_attr = false;
 
-    std::map<std::string, std::string> numpy2lpythontypes = {
+    static constexpr auto numpy2lpythontypes = make_static_map<std::string_view>({
         {"bool", "bool"},
         {"bool_", "bool"},
         {"int8", "i8"},
@@ -378,7 +552,7 @@ public:
         {"complex128", "c64"},
         {"complex_", "c64"},
         {"object", "T"}
-    };
+    });
 
     CommonVisitor(Allocator &al, LocationManager &lm, SymbolTable *symbol_table,
             diag::Diagnostics &diagnostics, bool main_module, std::string module_name,
@@ -1087,6 +1261,32 @@ public:
         return ASRUtils::make_Assignment_t_util(al, expr->base.loc, variable_var, expr, nullptr, false, false);
     }
 
+    // The key of `overload_cache` for a call to `p` with `args`: the overloads
+    // of `p` and the type and rank of every argument (missing optional
+    // arguments included). Returns false if a type has no name, such calls
+    // are resolved every time.
+    bool overload_cache_key(const ASR::GenericProcedure_t &p,
+            Vec<ASR::call_arg_t> &args, std::string &key) {
+        key = std::to_string((uintptr_t)&p) + ":"
+            + std::to_string((uintptr_t)p.m_procs) + ":"
+            + std::to_string(p.n_procs);
+        for (size_t i = 0; i < args.size(); i++) {
+            key += "|";
+            ASR::expr_t *arg = args[i].m_value;
+            if (arg == nullptr) {
+                continue;
+            }
+            ASR::ttype_t *type = ASRUtils::expr_type(arg);
+            try {
+                key += ASRUtils::type_to_str_python_expr(type, arg);
+            } catch (const LCompilersException &) {
+                return false;
+            }
+            key += "/" + std::to_string(ASRUtils::extract_n_dims_from_ttype(type));
+        }
+        return true;
+    }
+
     // Function to create appropriate call based on symbol type. If it is external
     // generic symbol then it changes the name accordingly.
     ASR::asr_t* make_call_helper(Allocator &al, ASR::symbol_t* s, SymbolTable *current_scope,
@@ -1142,8 +1342,20 @@ public:
                     throw SemanticError("Arguments do not match for any generic procedure, " + std::string(p->m_name), loc);
                 }
             } else {
-                idx = ASRUtils::select_generic_procedure(args, *p, loc,
-                        [&](const std::string &msg, const Location &loc) { throw SemanticError(msg, loc); });
+                std::string key;
+                bool cacheable = overload_cache_key(*p, args, key);
+                auto cached = cacheable ? overload_cache.find(key) : overload_cache.end();
+                if (cached != overload_cache.end()) {
+                    idx = cached->second;
+                    overload_cache_hits++;
+                } else {
+                    idx = ASRUtils::select_generic_procedure(args, *p, loc,
+                            [&](const std::string &msg, const Location &loc) { throw SemanticError(msg, loc); });
+                    if (cacheable) {
+                        overload_cache[key] = idx;
+                    }
+                    overload_cache_misses++;
+                }
             }
             s = p->m_procs[idx];
             std::string remote_sym = ASRUtils::symbol_name(s);
@@ -1276,6 +1488,12 @@ public:
                 args_new.reserve(al, func->n_args);
                 visit_expr_list_with_cast(func->m_args, func->n_args, args_new, args,
                     !ASRUtils::is_intrinsic_function2(func));
+                if (value == nullptr && comptime_eval_functions
+                        && !ASRUtils::is_intrinsic_function2(func)) {
+                    PythonFunctionEvaluator evaluator(al, comptime_eval_budget);
+                    value = evaluator.evaluate(func, args_new.p, args_new.size(),
+                        a_type, loc);
+                }
 
                 if (ASRUtils::symbol_parent_symtab(stemp)->get_counter() != current_scope->get_counter()) {
                     ADD_ASR_DEPENDENCIES(current_scope, stemp, dependencies);
@@ -3457,9 +3675,10 @@ public:
     }
 
     void visit_Name(const AST::Name_t &x) {
-        std::string name = x.m_id;
+        const std::string &name = name_str(x.m_id);
         ASR::symbol_t *s = current_scope->resolve_symbol(name);
-        std::set<std::string> not_cpython_builtin = {
+        // Every name is visited, do not build the set each time
+        static const std::set<std::string> not_cpython_builtin = {
             "pi", "E", "oo"};
         if (s) {
             tmp = ASR::make_Var_t(al, x.base.base.loc, s);
@@ -3526,8 +3745,201 @@ public:
                                     elements.p, elements.size(), tuple_type);
     }
 
+    // The largest intermediate result (in bits) of `fold_int_literals`
+    static const size_t max_folded_int_bits = 1 << 16;
+
+    struct FoldedInt {
+        bool ok;
+        bool large;
+        int64_t value;
+    };
+    std::unordered_map<const AST::expr_t*, FoldedInt> folded_int_literals;
+
+    /*
+        Evaluates `x` if it is an integer expression of literals only (`+`,
+        `-`, `*`, `//`, `%`, `**`, `<<`, `>>` and unary `-`, `+`), with
+        arbitrary precision. Returns false if it is not, or if it cannot be
+        evaluated (division by zero, ...), the usual code path handles it
+        then. `large` is set if a literal or an intermediate result does not
+        fit into i32 (the type of integer literals), i.e., if the fixed width
+        arithmetic would overflow.
+    */
+    bool fold_int_literals(const AST::expr_t &x, int64_t &value, bool &large) {
+        // Every BinOp of a long chain tries to fold its subexpression, the
+        // results are remembered so that this is linear in the chain length
+        auto memo = folded_int_literals.find(&x);
+        if (memo != folded_int_literals.end()) {
+            const FoldedInt &f = memo->second;
+            value = f.value;
+            large = large || f.large;
+            return f.ok;
+        }
+        bool sub_large = false;
+        bool ok = fold_int_literals_uncached(x, value, sub_large);
+        folded_int_literals[&x] = {ok, sub_large, value};
+        large = large || sub_large;
+        return ok;
+    }
+
+    bool fold_int_literals_uncached(const AST::expr_t &x, int64_t &value, bool &large) {
+        value = 0;
+        if (AST::is_a<AST::ConstantInt_t>(x)) {
+            value = AST::down_cast<AST::ConstantInt_t>(&x)->m_value;
+        } else if (AST::is_a<AST::UnaryOp_t>(x)) {
+            const AST::UnaryOp_t &u = *AST::down_cast<AST::UnaryOp_t>(&x);
+            int64_t a;
+            if (!fold_int_literals(*u.m_operand, a, large)) return false;
+            switch (u.m_op) {
+                case AST::unaryopType::USub: value = BigInt::neg(al, a); break;
+                case AST::unaryopType::UAdd: value = a; break;
+                default: return false;
+            }
+        } else if (AST::is_a<AST::BinOp_t>(x)) {
+            const AST::BinOp_t &b = *AST::down_cast<AST::BinOp_t>(&x);
+            int64_t l, r;
+            if (!fold_int_literals(*b.m_left, l, large)
+                    || !fold_int_literals(*b.m_right, r, large)) {
+                return false;
+            }
+            switch (b.m_op) {
+                case AST::operatorType::Add: value = BigInt::add(al, l, r); break;
+                case AST::operatorType::Sub: value = BigInt::sub(al, l, r); break;
+                case AST::operatorType::Mult: value = BigInt::mul(al, l, r); break;
+                case AST::operatorType::FloorDiv:
+                case AST::operatorType::Mod: {
+                    if (BigInt::compare(r, 0) == 0) return false;
+                    value = b.m_op == AST::operatorType::Mod
+                        ? BigInt::mod(al, l, r) : BigInt::floordiv(al, l, r);
+                    break;
+                }
+                case AST::operatorType::Pow: {
+                    // A negative exponent gives a float; the result has at
+                    // most bit_length(l) * r bits
+                    size_t bits = BigInt::bit_length(l);
+                    if (BigInt::compare(r, 0) < 0 || BigInt::is_int_ptr(r)
+                            || (bits > 1 && ((uint64_t)r > max_folded_int_bits
+                                || bits * (uint64_t)r > max_folded_int_bits))) {
+                        return false;
+                    }
+                    value = BigInt::pow(al, l, r);
+                    break;
+                }
+                case AST::operatorType::LShift:
+                case AST::operatorType::RShift: {
+                    if (BigInt::compare(r, 0) < 0 || BigInt::is_int_ptr(r)
+                            || (b.m_op == AST::operatorType::LShift
+                                && BigInt::bit_length(l) + r > max_folded_int_bits)) {
+                        return false;
+                    }
+                    value = b.m_op == AST::operatorType::LShift
+                        ? BigInt::lshift(al, l, r) : BigInt::rshift(al, l, r);
+                    break;
+                }
+                default: return false;
+            }
+        } else {
+            return false;
+        }
+        if (BigInt::is_int_ptr(value) || value < INT32_MIN || value > INT32_MAX) {
+            large = true;
+        }
+        return true;
+    }
+
+    struct FoldedReal {
+        bool ok;
+        bool huge;
+        double value;
+    };
+    std::unordered_map<const AST::expr_t*, FoldedReal> folded_real_literals;
+
+    /*
+        Evaluates `x` as a float if it is a literal expression of integer
+        subexpressions (see `fold_int_literals`) and float literals with `+`,
+        `-`, `*`, `/` and `**`. `huge` is set if one of the integer
+        subexpressions does not fit into i64: its value is then only used as
+        a float (`1/2**70`, `2**64 * 0.5`, ...), which the integer constants
+        of the usual code path cannot represent.
+    */
+    bool fold_real_literals(const AST::expr_t &x, double &value, bool &huge) {
+        auto memo = folded_real_literals.find(&x);
+        if (memo != folded_real_literals.end()) {
+            const FoldedReal &f = memo->second;
+            value = f.value;
+            huge = huge || f.huge;
+            return f.ok;
+        }
+        bool sub_huge = false;
+        bool ok = fold_real_literals_uncached(x, value, sub_huge);
+        folded_real_literals[&x] = {ok, sub_huge, value};
+        huge = huge || sub_huge;
+        return ok;
+    }
+
+    bool fold_real_literals_uncached(const AST::expr_t &x, double &value, bool &huge) {
+        value = 0;
+        int64_t i, as_i64;
+        bool large = false;
+        if (fold_int_literals(x, i, large)) {
+            if (!BigInt::to_int64(i, as_i64)) huge = true;
+            value = BigInt::to_double(i);
+        } else if (AST::is_a<AST::ConstantFloat_t>(x)) {
+            value = AST::down_cast<AST::ConstantFloat_t>(&x)->m_value;
+        } else if (AST::is_a<AST::UnaryOp_t>(x)) {
+            const AST::UnaryOp_t &u = *AST::down_cast<AST::UnaryOp_t>(&x);
+            double a;
+            if (!fold_real_literals(*u.m_operand, a, huge)) return false;
+            switch (u.m_op) {
+                case AST::unaryopType::USub: value = -a; break;
+                case AST::unaryopType::UAdd: value = a; break;
+                default: return false;
+            }
+        } else if (AST::is_a<AST::BinOp_t>(x)) {
+            const AST::BinOp_t &b = *AST::down_cast<AST::BinOp_t>(&x);
+            double l, r;
+            if (!fold_real_literals(*b.m_left, l, huge)
+                    || !fold_real_literals(*b.m_right, r, huge)) {
+                return false;
+            }
+            switch (b.m_op) {
+                case AST::operatorType::Add: value = l + r; break;
+                case AST::operatorType::Sub: value = l - r; break;
+                case AST::operatorType::Mult: value = l * r; break;
+                case AST::operatorType::Div: {
+                    if (r == 0) return false;
+                    value = l / r;
+                    break;
+                }
+                case AST::operatorType::Pow: value = std::pow(l, r); break;
+                default: return false;
+            }
+        } else {
+            return false;
+        }
+        // Python raises OverflowError (or gives a complex number), the usual
+        // code path reports it
+        return std::isfinite(value);
+    }
+
+    // An integer constant for the folded `value`, which is used as an
+    // integer: i32 if it fits (the type of integer literals), i64 otherwise
+    ASR::asr_t* make_folded_int_constant(int64_t value, const Location &loc) {
+        int64_t i;
+        if (!BigInt::to_int64(value, i)) {
+            throw SemanticError("Integer constant " + BigInt::int_to_str(value)
+                + " does not fit into i64", loc);
+        }
+        int kind = (i >= INT32_MIN && i <= INT32_MAX) ? 4 : 8;
+        ASR::ttype_t *type = ASRUtils::TYPE(ASR::make_Integer_t(al, loc, kind));
+        return ASR::make_IntegerConstant_t(al, loc, i, type);
+    }
+
     void visit_ConstantInt(const AST::ConstantInt_t &x) {
         int64_t i = x.m_value;
+        if (BigInt::is_int_ptr(i)) {
+            tmp = make_folded_int_constant(i, x.base.base.loc);
+            return;
+        }
         ASR::ttype_t *type = ASRUtils::TYPE(ASR::make_Integer_t(al, x.base.base.loc, 4));
         tmp = ASR::make_IntegerConstant_t(al, x.base.base.loc, i, type);
     }
@@ -3694,6 +4106,24 @@ public:
     }
 
     void visit_BinOp(const AST::BinOp_t &x) {
+        // Literal expressions with large intermediate results (hash
+        // constants, modular arithmetic, ...) are folded exactly
+        int64_t folded;
+        bool large = false;
+        double folded_real;
+        bool huge = false;
+        if (fold_int_literals(x.base, folded, large)) {
+            if (large) {
+                tmp = make_folded_int_constant(folded, x.base.base.loc);
+                return;
+            }
+        } else if (fold_real_literals(x.base, folded_real, huge) && huge) {
+            // An integer that does not fit into i64, but is only used as a
+            // float, e.g., `1/2**70`
+            ASR::ttype_t *type = ASRUtils::TYPE(ASR::make_Real_t(al, x.base.base.loc, 8));
+            tmp = ASR::make_RealConstant_t(al, x.base.base.loc, folded_real, type);
+            return;
+        }
         this->visit_expr(*x.m_left);
         ASR::expr_t *left = ASRUtils::EXPR(tmp);
         this->visit_expr(*x.m_right);
@@ -3750,6 +4180,14 @@ public:
     }
 
     void visit_UnaryOp(const AST::UnaryOp_t &x) {
+        // E.g., -2147483648 or -9223372036854775808 (the literal does not
+        // fit into i32)
+        int64_t folded;
+        bool large = false;
+        if (fold_int_literals(x.base, folded, large) && large) {
+            tmp = make_folded_int_constant(folded, x.base.base.loc);
+            return;
+        }
         this->visit_expr(*x.m_operand);
         ASR::expr_t *operand = ASRUtils::EXPR(tmp);
         ASR::ttype_t *operand_type = ASRUtils::expr_type(operand);
@@ -4794,6 +5232,8 @@ public:
             ASR::symbol_t *t = ASR::down_cast<ASR::symbol_t>(tmp);
             current_scope->add_symbol(def_name, t);
         }
+        // New overloads: the selections made so far may be stale
+        overload_cache.clear();
     }
 
     void set_module_symbol(std::string &mod_sym, std::vector<std::string> &paths) {
@@ -5483,7 +5923,7 @@ public:
             AST::expr_t *target = x.m_targets[i];
             if (AST::is_a<AST::Name_t>(*target)) {
                 AST::Name_t *n = AST::down_cast<AST::Name_t>(target);
-                std::string var_name = n->m_id;
+                const std::string &var_name = name_str(n->m_id);
                 if (!current_scope->resolve_symbol(var_name)) {
                     throw SemanticError("Symbol is not declared",
                             x.base.base.loc);
@@ -8361,7 +8801,7 @@ we will have to use something else.
                     return;
                 } else if (AST::is_a<AST::Name_t>(*call->m_func)) {
                     AST::Name_t *n = AST::down_cast<AST::Name_t>(call->m_func);
-                    std::string call_name = n->m_id;
+                    const std::string &call_name = name_str(n->m_id);
                     if (symbolic_functions.find(call_name) != symbolic_functions.end()) {
                         visit_Call(*call);
                         Vec<ASR::expr_t*> eles;
@@ -8491,7 +8931,7 @@ we will have to use something else.
         Vec<ASR::call_arg_t> args;
         if (AST::is_a<AST::Name_t>(*x.m_func)) {
             AST::Name_t *n = AST::down_cast<AST::Name_t>(x.m_func);
-            call_name = n->m_id;
+            call_name = name_str(n->m_id);
         } else if (AST::is_a<AST::Attribute_t>(*x.m_func)) {
             parse_args(x, args);
             AST::Attribute_t *at = AST::down_cast<AST::Attribute_t>(x.m_func);
@@ -8510,11 +8950,11 @@ we will have to use something else.
 
         if (!s) {
             std::string intrinsic_name = call_name;
-            std::set<std::string> not_cpython_builtin = {
+            static const std::set<std::string> not_cpython_builtin = {
                 "sin", "cos", "gamma", "tan", "asin", "acos", "atan", "sinh", "cosh", "tanh", "exp", "exp2", "expm1", "Symbol", "diff", "expand", "trunc", "fix", "subs",
                 "sum" // For sum called over lists
             };
-            std::set<std::string> symbolic_functions = {
+            static const std::set<std::string> symbolic_functions = {
                 "sin", "cos", "log", "exp", "Abs", "sign"
             };
             if ((symbolic_functions.find(call_name) != symbolic_functions.end()) &&
@@ -8698,8 +9138,8 @@ we will have to use something else.
                     LCOMPILERS_ASSERT(false);
                 }
 
-                if (numpy2lpythontypes.find(dtype_np) != numpy2lpythontypes.end()) {
-                    dtype_np = numpy2lpythontypes[dtype_np];
+                if (const std::string_view *t = numpy2lpythontypes.find(dtype_np)) {
+                    dtype_np = *t;
                 }
 
                 ASR::symbol_t* type_decl = nullptr;
@@ -8866,12 +9306,12 @@ we will have to use something else.
                     } else {
                         LCOMPILERS_ASSERT(false);
                     }
-                    LCOMPILERS_ASSERT(numpy2lpythontypes.find(dtype_np) != numpy2lpythontypes.end());
+                    LCOMPILERS_ASSERT(numpy2lpythontypes.contains(dtype_np));
                     Vec<ASR::dimension_t> dims;
                     dims.n = 0;
                     ASR::symbol_t* type_decl = nullptr;
                     type = get_type_from_var_annotation(
-                        numpy2lpythontypes[dtype_np], x.base.base.loc, dims, type_decl);
+                        std::string(*numpy2lpythontypes.find(dtype_np)), x.base.base.loc, dims, type_decl);
                 }
                 if( args.size() != 1 ) {
                     throw SemanticError("array accepts only 1 argument for now, got " +
@@ -9106,9 +9546,10 @@ Result<ASR::TranslationUnit_t*> body_visitor(Allocator &al, LocationManager &lm,
         diag::Diagnostics &diagnostics,
         ASR::asr_t *unit, bool main_module, std::string module_name,
         std::map<int, ASR::symbol_t*> &ast_overload,
-        bool allow_implicit_casting, size_t eval_count)
+        bool allow_implicit_casting, size_t eval_count, bool comptime_eval_functions)
 {
     BodyVisitor b(al, lm, unit, diagnostics, main_module, module_name, ast_overload, allow_implicit_casting, eval_count);
+    b.comptime_eval_functions = comptime_eval_functions;
     try {
         b.visit_Module(ast);
     } catch (const SemanticError &e) {
@@ -9176,8 +9617,13 @@ Result<ASR::TranslationUnit_t*> python_ast_to_asr(Allocator &al, LocationManager
 #endif
 
     if (!compiler_options.symtab_only) {
+        // The calls of user functions are only evaluated at compile time with
+        // `--fast`: the evaluation can take up to its fuel budget, and
+        // without it every call stays in the generated code (a breakpoint or
+        // a stack trace in the function still works)
         auto res2 = body_visitor(al, lm, *ast_m, diagnostics, unit, main_module, module_name,
-            ast_overload, allow_implicit_casting, eval_count);
+            ast_overload, allow_implicit_casting, eval_count,
+            compiler_options.po.fast);
         if (res2.ok) {
             tu = res2.result;
         } else {
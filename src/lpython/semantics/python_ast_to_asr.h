@@ -10,6 +10,17 @@ namespace LCompilers::LPython {
         LPython::AST::ast_t &ast, diag::Diagnostics &diagnostics, CompilerOptions &compiler_options,
             bool main_module, std::string module_name, std::string file_path, bool allow_implicit_casting=false, size_t eval_count=0);
 
+    // The calls to a GenericProcedure (with positional arguments only) whose
+    // overload was found in the overload cache of the AST -> ASR visitor, and
+    // those whose overload was selected by matching the arguments, by all the
+    // compilations of this process
+    struct OverloadCacheStats {
+        size_t hits;
+        size_t misses;
+    };
+
+    OverloadCacheStats get_overload_cache_stats();
+
     int save_pyc_files(const ASR::TranslationUnit_t &u,
                        std::string infile, LocationManager& lm);
 
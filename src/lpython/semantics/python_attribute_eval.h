@@ -6,6 +6,7 @@
 #include <libasr/string_utils.h>
 #include <lpython/utils.h>
 #include <lpython/semantics/semantic_exception.h>
+#include <lpython/semantics/static_map.h>
 #include <libasr/pass/intrinsic_function_registry.h>
 
 namespace LCompilers::LPython {
@@ -15,11 +16,8 @@ struct AttributeHandler {
     typedef ASR::asr_t* (*attribute_eval_callback)(ASR::expr_t*, Allocator &,
                                 const Location &, Vec<ASR::expr_t*> &, diag::Diagnostics &);
 
-    std::map<std::string, attribute_eval_callback> attribute_map, symbolic_attribute_map;
-    std::set<std::string> modify_attr_set;
-
-    AttributeHandler() {
-        attribute_map = {
+    static const auto &attribute_map() {
+        static constexpr auto map = make_static_map<attribute_eval_callback>({
             {"int@bit_length", &eval_int_bit_length},
             {"array@size", &eval_array_size},
             {"list@append", &eval_list_append},
@@ -40,20 +38,28 @@ struct AttributeHandler {
             {"dict@keys", &eval_dict_keys},
             {"dict@values", &eval_dict_values},
             {"dict@clear", &eval_dict_clear}
-        };
+        });
+        return map;
+    }
 
-        modify_attr_set = {"list@append", "list@remove",
-            "list@reverse", "list@clear", "list@insert", "list@pop",
-            "set@pop", "set@add", "set@remove", "set@discard", "dict@pop"};
+    static const auto &modify_attr_set() {
+        static constexpr auto set = make_static_set({"list@append",
+            "list@remove", "list@reverse", "list@clear", "list@insert",
+            "list@pop", "set@pop", "set@add", "set@remove", "set@discard",
+            "dict@pop"});
+        return set;
+    }
 
-        symbolic_attribute_map = {
+    static const auto &symbolic_attribute_map() {
+        static constexpr auto map = make_static_map<attribute_eval_callback>({
             {"diff", &eval_symbolic_diff},
             {"expand", &eval_symbolic_expand},
             {"has", &eval_symbolic_has_symbol},
             {"is_integer", &eval_symbolic_is_integer},
             {"is_positive", &eval_symbolic_is_positive},
             {"subs", &eval_symbolic_subs}
-        };
+        });
+        return map;
     }
 
     std::string get_type_name(ASR::ttype_t *t) {
@@ -79,7 +85,7 @@ struct AttributeHandler {
             throw SemanticError("Type name is not implemented yet.", loc);
         }
         std::string key = class_name + "@" + attr_name;
-        if (modify_attr_set.find(key) != modify_attr_set.end()) {
+        if (modify_attr_set().contains(key)) {
             if (ASR::is_a<ASR::Var_t>(*e)) {
                 ASR::Variable_t* v = ASRUtils::EXPR2VAR(e);
                 if (v->m_intent == ASRUtils::intent_in) {
@@ -88,10 +94,9 @@ struct AttributeHandler {
                 }
             }
         }
-        auto search = attribute_map.find(key);
-        if (search != attribute_map.end()) {
-            attribute_eval_callback cb = search->second;
-            return cb(e, al, loc, args, diag);
+        const attribute_eval_callback *cb = attribute_map().find(key);
+        if (cb) {
+            return (*cb)(e, al, loc, args, diag);
         } else {
             throw SemanticError(class_name + "." + attr_name + " is not implemented yet",
                 loc);
@@ -100,11 +105,9 @@ struct AttributeHandler {
 
     ASR::asr_t* get_symbolic_attribute(ASR::expr_t *e, std::string attr_name,
             Allocator &al, const Location &loc, Vec<ASR::expr_t*> &args, diag::Diagnostics &diag) {
-        std::string key = attr_name;
-        auto search = symbolic_attribute_map.find(key);
-        if (search != symbolic_attribute_map.end()) {
-            attribute_eval_callback cb = search->second;
-            return cb(e, al, loc, args, diag);
+        const attribute_eval_callback *cb = symbolic_attribute_map().find(attr_name);
+        if (cb) {
+            return (*cb)(e, al, loc, args, diag);
         } else {
             throw SemanticError("S." + attr_name + " is not implemented yet",
                 loc);
@@ -14,34 +14,32 @@
 #include <libasr/string_utils.h>
 #include <lpython/utils.h>
 #include <lpython/semantics/semantic_exception.h>
+#include <lpython/semantics/static_map.h>
 #include <libasr/asr_utils.h>
 
 namespace LCompilers::LPython {
 
 struct ProceduresDatabase {
-    std::map<std::string, std::set<std::string>> to_be_ignored;
-
-    ProceduresDatabase() {
-        to_be_ignored = {{"numpy", {"empty", "int64", "int32",
-                                    "float32", "float64",
-                                    "reshape", "array", "int16",
-                                    "complex64", "complex128",
-                                    "int8", "exp", "exp2",
-                                    "uint8", "uint16", "uint32", "uint64",
-                                    "size", "bool_"}},
-                         {"math", {"sin", "cos", "tan",
-                                    "asin", "acos", "atan",
-                                    "exp", "exp2", "expm1"}},
-                         {"enum", {"Enum"}}
-                        };
+    // "module@function"
+    static const auto &to_be_ignored() {
+        static constexpr auto set = make_static_set({
+            "numpy@empty", "numpy@int64", "numpy@int32",
+            "numpy@float32", "numpy@float64",
+            "numpy@reshape", "numpy@array", "numpy@int16",
+            "numpy@complex64", "numpy@complex128",
+            "numpy@int8", "numpy@exp", "numpy@exp2",
+            "numpy@uint8", "numpy@uint16", "numpy@uint32", "numpy@uint64",
+            "numpy@size", "numpy@bool_",
+            "math@sin", "math@cos", "math@tan",
+            "math@asin", "math@acos", "math@atan",
+            "math@exp", "math@exp2", "math@expm1",
+            "enum@Enum"});
+        return set;
     }
 
     bool is_function_to_be_ignored(std::string& module_name,
                                    std::string& function_name) {
-        if( to_be_ignored.find(module_name) == to_be_ignored.end() ) {
-            return false;
-        }
-        return to_be_ignored[module_name].find(function_name) != to_be_ignored[module_name].end();
+        return to_be_ignored().contains(module_name + "@" + function_name);
     }
 
 };
@@ -55,74 +53,67 @@ struct PythonIntrinsicProcedures {
     // The callback is only called if all arguments have compile time `value`
     // which is always one of the `Constant*` expression ASR nodes, so inside
     // the callback one can assume that.
-    std::map<std::string, std::tuple<std::string, comptime_eval_callback>> comptime_eval_map;
-
-    PythonIntrinsicProcedures() {
-        comptime_eval_map = {
-            // {"abs", {m_builtin, &eval_abs}},
-            {"pow", {m_builtin, &eval_pow}},
-            {"round", {m_builtin, &eval_round}},
-            {"bin", {m_builtin, &eval_bin}},
-            {"hex", {m_builtin, &eval_hex}},
-            {"oct", {m_builtin, &eval_oct}},
-            {"list", {m_builtin, &eval_list}},
-            {"complex", {m_builtin, &eval_complex}},
-            {"_lpython_imag", {m_builtin, &eval__lpython_imag}},
-            {"divmod", {m_builtin, &eval_divmod}},
-            {"_lpython_floordiv", {m_builtin, &eval__lpython_floordiv}},
-            {"_mod", {m_builtin, &eval__mod}},
-            {"max" , {m_builtin , &eval_max}},
-            {"min" , {m_builtin , &eval_min}},
-            {"sum" , {m_builtin , &not_implemented}},
+    // All of them are in the `m_builtin` module
+    static const auto &comptime_eval_map() {
+        static constexpr auto map = make_static_map<comptime_eval_callback>({
+            // {"abs", &eval_abs},
+            {"pow", &eval_pow},
+            {"round", &eval_round},
+            {"bin", &eval_bin},
+            {"hex", &eval_hex},
+            {"oct", &eval_oct},
+            {"list", &eval_list},
+            {"complex", &eval_complex},
+            {"_lpython_imag", &eval__lpython_imag},
+            {"divmod", &eval_divmod},
+            {"_lpython_floordiv", &eval__lpython_floordiv},
+            {"_mod", &eval__mod},
+            {"max" , &eval_max},
+            {"min" , &eval_min},
+            {"sum" , &not_implemented},
             // The following functions for string methods are not used
             // for evaluation.
-            {"_lpython_str_capitalize", {m_builtin, &not_implemented}},
-            {"_lpython_str_count", {m_builtin, &not_implemented}},
-            {"_lpython_str_lower", {m_builtin, &not_implemented}},
-            {"_lpython_str_upper", {m_builtin, &not_implemented}},
-            {"_lpython_str_join", {m_builtin, &not_implemented}},
-            {"_lpython_str_find", {m_builtin, &not_implemented}},
-            {"_lpython_str_isalpha", {m_builtin, &not_implemented}},
-            {"_lpython_str_isalnum", {m_builtin, &not_implemented}},
-            {"_lpython_str_isnumeric", {m_builtin, &not_implemented}},
-            {"_lpython_str_title", {m_builtin, &not_implemented}},
-            {"_lpython_str_istitle", {m_builtin, &not_implemented}},
-            {"_lpython_str_rstrip", {m_builtin, &not_implemented}},
-            {"_lpython_str_lstrip", {m_builtin, &not_implemented}},
-            {"_lpython_str_strip", {m_builtin, &not_implemented}},
-            {"_lpython_str_split", {m_builtin, &not_implemented}},
-            {"_lpython_str_replace", {m_builtin, &not_implemented}},
-            {"_lpython_str_swapcase", {m_builtin, &not_implemented}},
-            {"_lpython_str_startswith", {m_builtin, &not_implemented}},
-            {"_lpython_str_endswith", {m_builtin, &not_implemented}},
-            {"_lpython_str_partition", {m_builtin, &not_implemented}},
-            {"_lpython_str_islower", {m_builtin, &not_implemented}},
-            {"_lpython_str_isupper", {m_builtin, &not_implemented}},
-            {"_lpython_str_isdecimal", {m_builtin, &not_implemented}},
-            {"_lpython_str_isascii", {m_builtin, &not_implemented}},
-            {"_lpython_str_isspace", {m_builtin, &not_implemented}},
-            {"_lpython_str_center", {m_builtin, &not_implemented}},
-            {"_lpython_str_expandtabs", {m_builtin, &not_implemented}}
-        };
+            {"_lpython_str_capitalize", &not_implemented},
+            {"_lpython_str_count", &not_implemented},
+            {"_lpython_str_lower", &not_implemented},
+            {"_lpython_str_upper", &not_implemented},
+            {"_lpython_str_join", &not_implemented},
+            {"_lpython_str_find", &not_implemented},
+            {"_lpython_str_isalpha", &not_implemented},
+            {"_lpython_str_isalnum", &not_implemented},
+            {"_lpython_str_isnumeric", &not_implemented},
+            {"_lpython_str_title", &not_implemented},
+            {"_lpython_str_istitle", &not_implemented},
+            {"_lpython_str_rstrip", &not_implemented},
+            {"_lpython_str_lstrip", &not_implemented},
+            {"_lpython_str_strip", &not_implemented},
+            {"_lpython_str_split", &not_implemented},
+            {"_lpython_str_replace", &not_implemented},
+            {"_lpython_str_swapcase", &not_implemented},
+            {"_lpython_str_startswith", &not_implemented},
+            {"_lpython_str_endswith", &not_implemented},
+            {"_lpython_str_partition", &not_implemented},
+            {"_lpython_str_islower", &not_implemented},
+            {"_lpython_str_isupper", &not_implemented},
+            {"_lpython_str_isdecimal", &not_implemented},
+            {"_lpython_str_isascii", &not_implemented},
+            {"_lpython_str_isspace", &not_implemented},
+            {"_lpython_str_center", &not_implemented},
+            {"_lpython_str_expandtabs", &not_implemented}
+        });
+        return map;
     }
 
     // Return `true` if `name` is in the table of intrinsics
     bool is_intrinsic(std::string name) const {
-        auto search = comptime_eval_map.find(name);
-        if (search != comptime_eval_map.end()) {
-            return true;
-        } else {
-            return false;
-        }
+        return comptime_eval_map().contains(name);
     }
 
     // Looks up `name` in the table of intrinsics and returns the corresponding
     // module name; Otherwise rises an exception
     std::string get_module(std::string name, const Location &loc) const {
-        auto search = comptime_eval_map.find(name);
-        if (search != comptime_eval_map.end()) {
-            std::string module_name = std::get<0>(search->second);
-            return module_name;
+        if (comptime_eval_map().contains(name)) {
+            return m_builtin;
         } else {
             throw SemanticError("Function '" + name
                 + "' not found among intrinsic procedures",
@@ -132,9 +123,9 @@ struct PythonIntrinsicProcedures {
 
     // Evaluates the intrinsic function `name` at compile time
     ASR::expr_t *comptime_eval(std::string name, Allocator &al, const Location &loc, Vec<ASR::call_arg_t> &args) const {
-        auto search = comptime_eval_map.find(name);
-        if (search != comptime_eval_map.end()) {
-            comptime_eval_callback cb = std::get<1>(search->second);
+        const comptime_eval_callback *search = comptime_eval_map().find(name);
+        if (search) {
+            comptime_eval_callback cb = *search;
             Vec<ASR::call_arg_t> arg_values = ASRUtils::get_arg_values(al, args);
             if (arg_values.size() != args.size()) {
                 // Not all arguments have compile time values; we do not call the callback
@@ -0,0 +1,497 @@
+#ifndef LPYTHON_SEMANTICS_FUNCTION_EVAL_H
+#define LPYTHON_SEMANTICS_FUNCTION_EVAL_H
+
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <libasr/asr.h>
+#include <libasr/asr_utils.h>
+#include <libasr/pass/intrinsic_function_registry.h>
+
+namespace LCompilers::LPython {
+
+/*
+    Evaluates calls to user defined functions at compile time, when all the
+    arguments have compile time values, by interpreting the ASR of their
+    bodies. Helper functions that compute bit masks, configuration constants,
+    ... are then folded into constants (the `value` of the FunctionCall)
+    instead of being computed at run time.
+
+    Only a side effect free subset is interpreted: integer, real and logical
+    scalars, assignments to local variables, `if`, `while`, `for` over a
+    range, `break`, `continue`, `return` and calls to functions of the same
+    subset. Everything else (printing, global variables that are not
+    constants, lists, strings, ...) makes the evaluation fail and the call is
+    left as it is.
+
+    Every statement and expression costs one unit of `fuel`, the evaluation
+    fails when the fuel is exhausted, so a call that does not terminate (or
+    takes too long) is also left to the run time. The units are also taken
+    from the `budget` of the whole compilation, which the caller shares
+    between the evaluators of all call sites: once it is spent, no more calls
+    are evaluated, so many call sites cannot multiply the compile time.
+*/
+class PythonFunctionEvaluator {
+public:
+    // Per call site
+    static const size_t default_fuel = 100000;
+    // Per compilation
+    static const size_t default_budget = 2000000;
+    static const size_t max_depth = 64;
+
+    PythonFunctionEvaluator(Allocator &al, size_t &budget,
+            size_t fuel=default_fuel)
+        : al{al}, budget{budget}, fuel{fuel} {}
+
+    // Returns the value of the call of `func` with `args` (whose values must
+    // be compile time constants) as a constant of type `type`, or nullptr if
+    // the call cannot be evaluated.
+    ASR::expr_t *evaluate(ASR::Function_t *func, ASR::call_arg_t *args,
+            size_t n_args, ASR::ttype_t *type, const Location &loc) {
+        depth = 0;
+        try {
+            std::vector<Value> arg_values;
+            for (size_t i = 0; i < n_args; i++) {
+                ASR::expr_t *arg = args[i].m_value;
+                if (arg == nullptr || ASRUtils::expr_value(arg) == nullptr) {
+                    return nullptr;
+                }
+                arg_values.push_back(constant(ASRUtils::expr_value(arg)));
+            }
+            Value result = call(func, arg_values);
+            return make_constant(result, type, loc);
+        } catch (const CannotEvaluate &) {
+            return nullptr;
+        }
+    }
+
+private:
+    struct CannotEvaluate {};
+
+    struct Value {
+        enum class Kind { Integer, Real, Logical };
+        Kind kind = Kind::Integer;
+        int64_t i = 0;
+        double r = 0;
+        bool b = false;
+    };
+
+    enum class Flow { Next, Break, Continue, Return };
+
+    // The local variables of a call
+    typedef std::unordered_map<ASR::symbol_t*, Value> Frame;
+
+    Allocator &al;
+    size_t &budget;
+    size_t fuel;
+    size_t depth = 0;
+
+    void consume() {
+        if (fuel == 0 || budget == 0) throw CannotEvaluate();
+        fuel--;
+        budget--;
+    }
+
+    static Value integer(int64_t i) {
+        Value v; v.kind = Value::Kind::Integer; v.i = i; return v;
+    }
+
+    static Value real(double r) {
+        Value v; v.kind = Value::Kind::Real; v.r = r; return v;
+    }
+
+    static Value logical(bool b) {
+        Value v; v.kind = Value::Kind::Logical; v.b = b; return v;
+    }
+
+    static int64_t as_integer(const Value &v) {
+        if (v.kind != Value::Kind::Integer) throw CannotEvaluate();
+        return v.i;
+    }
+
+    static double as_real(const Value &v) {
+        if (v.kind != Value::Kind::Real) throw CannotEvaluate();
+        return v.r;
+    }
+
+    static bool as_logical(const Value &v) {
+        if (v.kind != Value::Kind::Logical) throw CannotEvaluate();
+        return v.b;
+    }
+
+    // Wraps around like the generated code does
+    static int64_t wrap(uint64_t i, ASR::ttype_t *type) {
+        switch (ASRUtils::extract_kind_from_ttype_t(type)) {
+            case 1: return (int8_t)i;
+            case 2: return (int16_t)i;
+            case 4: return (int32_t)i;
+            case 8: return (int64_t)i;
+            default: throw CannotEvaluate();
+        }
+    }
+
+    static double round_real(double r, ASR::ttype_t *type) {
+        return ASRUtils::extract_kind_from_ttype_t(type) == 4 ? (float)r : r;
+    }
+
+    static bool is_scalar(ASR::ttype_t *type) {
+        return ASRUtils::is_integer(*type) || ASRUtils::is_real(*type)
+            || ASRUtils::is_logical(*type);
+    }
+
+    static Value constant(ASR::expr_t *x) {
+        switch (x->type) {
+            case ASR::exprType::IntegerConstant:
+                return integer(ASR::down_cast<ASR::IntegerConstant_t>(x)->m_n);
+            case ASR::exprType::RealConstant:
+                return real(ASR::down_cast<ASR::RealConstant_t>(x)->m_r);
+            case ASR::exprType::LogicalConstant:
+                return logical(ASR::down_cast<ASR::LogicalConstant_t>(x)->m_value);
+            default:
+                throw CannotEvaluate();
+        }
+    }
+
+    ASR::expr_t *make_constant(const Value &v, ASR::ttype_t *type,
+            const Location &loc) {
+        if (ASRUtils::is_integer(*type)) {
+            return ASRUtils::EXPR(ASR::make_IntegerConstant_t(al, loc,
+                as_integer(v), type));
+        } else if (ASRUtils::is_real(*type)) {
+            return ASRUtils::EXPR(ASR::make_RealConstant_t(al, loc,
+                as_real(v), type));
+        } else if (ASRUtils::is_logical(*type)) {
+            return ASRUtils::EXPR(ASR::make_LogicalConstant_t(al, loc,
+                as_logical(v), type));
+        }
+        throw CannotEvaluate();
+    }
+
+    Value call(ASR::Function_t *func, const std::vector<Value> &args) {
+        ASR::FunctionType_t *ftype = ASRUtils::get_FunctionType(func);
+        if (depth == max_depth || func->m_return_var == nullptr
+                || func->n_body == 0 || func->n_args != args.size()
+                || ftype->m_deftype != ASR::deftypeType::Implementation
+                || (ftype->m_abi != ASR::abiType::Source
+                    && ftype->m_abi != ASR::abiType::Intrinsic)) {
+            throw CannotEvaluate();
+        }
+        Frame frame;
+        for (size_t i = 0; i < func->n_args; i++) {
+            ASR::Variable_t *arg = ASRUtils::EXPR2VAR(func->m_args[i]);
+            // The caller would see the changes of `out` arguments
+            if (!is_scalar(arg->m_type) || arg->m_intent == ASR::intentType::Out
+                    || arg->m_intent == ASR::intentType::InOut) {
+                throw CannotEvaluate();
+            }
+            frame[&arg->base] = args[i];
+        }
+        depth++;
+        execute(func, frame, func->m_body, func->n_body);
+        depth--;
+        ASR::symbol_t *return_var = ASR::down_cast<ASR::Var_t>(
+            func->m_return_var)->m_v;
+        auto result = frame.find(return_var);
+        if (result == frame.end()) throw CannotEvaluate();
+        return result->second;
+    }
+
+    Flow execute(ASR::Function_t *func, Frame &frame, ASR::stmt_t **body,
+            size_t n_body) {
+        for (size_t i = 0; i < n_body; i++) {
+            Flow flow = execute(func, frame, body[i]);
+            if (flow != Flow::Next) return flow;
+        }
+        return Flow::Next;
+    }
+
+    Flow execute(ASR::Function_t *func, Frame &frame, ASR::stmt_t *x) {
+        consume();
+        switch (x->type) {
+            case ASR::stmtType::Assignment: {
+                ASR::Assignment_t *a = ASR::down_cast<ASR::Assignment_t>(x);
+                if (!ASR::is_a<ASR::Var_t>(*a->m_target)) throw CannotEvaluate();
+                ASR::symbol_t *v = ASR::down_cast<ASR::Var_t>(a->m_target)->m_v;
+                // Only the variables of this call can be changed
+                if (!ASR::is_a<ASR::Variable_t>(*v)
+                        || ASRUtils::symbol_parent_symtab(v) != func->m_symtab
+                        || !is_scalar(ASRUtils::symbol_type(v))) {
+                    throw CannotEvaluate();
+                }
+                frame[v] = eval(frame, a->m_value);
+                return Flow::Next;
+            }
+            case ASR::stmtType::If: {
+                ASR::If_t *s = ASR::down_cast<ASR::If_t>(x);
+                if (as_logical(eval(frame, s->m_test))) {
+                    return execute(func, frame, s->m_body, s->n_body);
+                }
+                return execute(func, frame, s->m_orelse, s->n_orelse);
+            }
+            case ASR::stmtType::WhileLoop: {
+                ASR::WhileLoop_t *s = ASR::down_cast<ASR::WhileLoop_t>(x);
+                while (as_logical(eval(frame, s->m_test))) {
+                    Flow flow = execute(func, frame, s->m_body, s->n_body);
+                    if (flow == Flow::Return) return flow;
+                    // The `else` block is skipped by `break`
+                    if (flow == Flow::Break) return Flow::Next;
+                    consume();
+                }
+                return execute(func, frame, s->m_orelse, s->n_orelse);
+            }
+            case ASR::stmtType::DoLoop: {
+                ASR::DoLoop_t *s = ASR::down_cast<ASR::DoLoop_t>(x);
+                ASR::do_loop_head_t &head = s->m_head;
+                if (head.m_v == nullptr || !ASR::is_a<ASR::Var_t>(*head.m_v)) {
+                    throw CannotEvaluate();
+                }
+                ASR::symbol_t *v = ASR::down_cast<ASR::Var_t>(head.m_v)->m_v;
+                if (ASRUtils::symbol_parent_symtab(v) != func->m_symtab) {
+                    throw CannotEvaluate();
+                }
+                int64_t start = as_integer(eval(frame, head.m_start));
+                int64_t end = as_integer(eval(frame, head.m_end));
+                int64_t step = head.m_increment
+                    ? as_integer(eval(frame, head.m_increment)) : 1;
+                if (step == 0) throw CannotEvaluate();
+                // The end is included
+                for (int64_t i = start; step > 0 ? i <= end : i >= end; i += step) {
+                    frame[v] = integer(i);
+                    Flow flow = execute(func, frame, s->m_body, s->n_body);
+                    if (flow == Flow::Return) return flow;
+                    if (flow == Flow::Break) return Flow::Next;
+                    consume();
+                }
+                return execute(func, frame, s->m_orelse, s->n_orelse);
+            }
+            case ASR::stmtType::Exit: {
+                if (ASR::down_cast<ASR::Exit_t>(x)->m_stmt_name) throw CannotEvaluate();
+                return Flow::Break;
+            }
+            case ASR::stmtType::Cycle: {
+                if (ASR::down_cast<ASR::Cycle_t>(x)->m_stmt_name) throw CannotEvaluate();
+                return Flow::Continue;
+            }
+            case ASR::stmtType::Return: {
+                return Flow::Return;
+            }
+            default:
+                throw CannotEvaluate();
+        }
+    }
+
+    Value eval(Frame &frame, ASR::expr_t *x) {
+        consume();
+        if (ASRUtils::expr_value(x)) {
+            return constant(ASRUtils::expr_value(x));
+        }
+        switch (x->type) {
+            case ASR::exprType::Var: {
+                ASR::symbol_t *v = ASR::down_cast<ASR::Var_t>(x)->m_v;
+                auto local = frame.find(v);
+                if (local != frame.end()) return local->second;
+                // Constants, of this function or of a module
+                v = ASRUtils::symbol_get_past_external(v);
+                if (ASR::is_a<ASR::Variable_t>(*v)) {
+                    ASR::Variable_t *var = ASR::down_cast<ASR::Variable_t>(v);
+                    if (var->m_storage == ASR::storage_typeType::Parameter
+                            && var->m_value) {
+                        return constant(var->m_value);
+                    }
+                }
+                throw CannotEvaluate();
+            }
+            case ASR::exprType::IntegerBinOp: {
+                ASR::IntegerBinOp_t *e = ASR::down_cast<ASR::IntegerBinOp_t>(x);
+                uint64_t a = as_integer(eval(frame, e->m_left));
+                uint64_t b = as_integer(eval(frame, e->m_right));
+                return integer(wrap(integer_binop(e->m_op, a, b), e->m_type));
+            }
+            case ASR::exprType::RealBinOp: {
+                ASR::RealBinOp_t *e = ASR::down_cast<ASR::RealBinOp_t>(x);
+                double a = as_real(eval(frame, e->m_left));
+                double b = as_real(eval(frame, e->m_right));
+                double r;
+                switch (e->m_op) {
+                    case ASR::binopType::Add: r = a + b; break;
+                    case ASR::binopType::Sub: r = a - b; break;
+                    case ASR::binopType::Mul: r = a * b; break;
+                    case ASR::binopType::Div: {
+                        // ZeroDivisionError at run time
+                        if (b == 0) throw CannotEvaluate();
+                        r = a / b;
+                        break;
+                    }
+                    case ASR::binopType::Pow: r = std::pow(a, b); break;
+                    default: throw CannotEvaluate();
+                }
+                return real(round_real(r, e->m_type));
+            }
+            case ASR::exprType::IntegerCompare: {
+                ASR::IntegerCompare_t *e = ASR::down_cast<ASR::IntegerCompare_t>(x);
+                return logical(compare(e->m_op, as_integer(eval(frame, e->m_left)),
+                    as_integer(eval(frame, e->m_right))));
+            }
+            case ASR::exprType::RealCompare: {
+                ASR::RealCompare_t *e = ASR::down_cast<ASR::RealCompare_t>(x);
+                return logical(compare(e->m_op, as_real(eval(frame, e->m_left)),
+                    as_real(eval(frame, e->m_right))));
+            }
+            case ASR::exprType::LogicalCompare: {
+                ASR::LogicalCompare_t *e = ASR::down_cast<ASR::LogicalCompare_t>(x);
+                return logical(compare(e->m_op, as_logical(eval(frame, e->m_left)),
+                    as_logical(eval(frame, e->m_right))));
+            }
+            case ASR::exprType::LogicalBinOp: {
+                ASR::LogicalBinOp_t *e = ASR::down_cast<ASR::LogicalBinOp_t>(x);
+                bool a = as_logical(eval(frame, e->m_left));
+                bool b = as_logical(eval(frame, e->m_right));
+                switch (e->m_op) {
+                    case ASR::logicalbinopType::And: return logical(a && b);
+                    case ASR::logicalbinopType::Or: return logical(a || b);
+                    case ASR::logicalbinopType::Xor: return logical(a != b);
+                    case ASR::logicalbinopType::NEqv: return logical(a != b);
+                    case ASR::logicalbinopType::Eqv: return logical(a == b);
+                    default: throw CannotEvaluate();
+                }
+            }
+            case ASR::exprType::LogicalNot: {
+                ASR::LogicalNot_t *e = ASR::down_cast<ASR::LogicalNot_t>(x);
+                return logical(!as_logical(eval(frame, e->m_arg)));
+            }
+            case ASR::exprType::IntegerUnaryMinus: {
+                ASR::IntegerUnaryMinus_t *e = ASR::down_cast<ASR::IntegerUnaryMinus_t>(x);
+                uint64_t a = as_integer(eval(frame, e->m_arg));
+                return integer(wrap(0 - a, e->m_type));
+            }
+            case ASR::exprType::IntegerBitNot: {
+                ASR::IntegerBitNot_t *e = ASR::down_cast<ASR::IntegerBitNot_t>(x);
+                uint64_t a = as_integer(eval(frame, e->m_arg));
+                return integer(wrap(~a, e->m_type));
+            }
+            case ASR::exprType::RealUnaryMinus: {
+                ASR::RealUnaryMinus_t *e = ASR::down_cast<ASR::RealUnaryMinus_t>(x);
+                return real(-as_real(eval(frame, e->m_arg)));
+            }
+            case ASR::exprType::Cast: {
+                ASR::Cast_t *e = ASR::down_cast<ASR::Cast_t>(x);
+                return cast(e->m_kind, eval(frame, e->m_arg), e->m_type);
+            }
+            case ASR::exprType::IfExp: {
+                ASR::IfExp_t *e = ASR::down_cast<ASR::IfExp_t>(x);
+                return as_logical(eval(frame, e->m_test))
+                    ? eval(frame, e->m_body) : eval(frame, e->m_orelse);
+            }
+            case ASR::exprType::IntrinsicElementalFunction: {
+                ASR::IntrinsicElementalFunction_t *e =
+                    ASR::down_cast<ASR::IntrinsicElementalFunction_t>(x);
+                // `a // b`
+                if (static_cast<ASRUtils::IntrinsicElementalFunctions>(e->m_intrinsic_id)
+                        != ASRUtils::IntrinsicElementalFunctions::FloorDiv
+                        || e->n_args != 2 || !ASRUtils::is_integer(*e->m_type)) {
+                    throw CannotEvaluate();
+                }
+                int64_t a = as_integer(eval(frame, e->m_args[0]));
+                int64_t b = as_integer(eval(frame, e->m_args[1]));
+                if (b == 0 || (b == -1 && a == INT64_MIN)) throw CannotEvaluate();
+                int64_t q = a / b;
+                if ((a % b != 0) && ((a < 0) != (b < 0))) q--;
+                return integer(wrap(q, e->m_type));
+            }
+            case ASR::exprType::FunctionCall: {
+                ASR::FunctionCall_t *e = ASR::down_cast<ASR::FunctionCall_t>(x);
+                ASR::symbol_t *f = ASRUtils::symbol_get_past_external(e->m_name);
+                if (!ASR::is_a<ASR::Function_t>(*f) || e->m_dt) {
+                    throw CannotEvaluate();
+                }
+                std::vector<Value> args;
+                for (size_t i = 0; i < e->n_args; i++) {
+                    if (e->m_args[i].m_value == nullptr) throw CannotEvaluate();
+                    args.push_back(eval(frame, e->m_args[i].m_value));
+                }
+                return call(ASR::down_cast<ASR::Function_t>(f), args);
+            }
+            default:
+                throw CannotEvaluate();
+        }
+    }
+
+    static uint64_t integer_binop(ASR::binopType op, uint64_t a, uint64_t b) {
+        switch (op) {
+            case ASR::binopType::Add: return a + b;
+            case ASR::binopType::Sub: return a - b;
+            case ASR::binopType::Mul: return a * b;
+            case ASR::binopType::BitAnd: return a & b;
+            case ASR::binopType::BitOr: return a | b;
+            case ASR::binopType::BitXor: return a ^ b;
+            case ASR::binopType::BitLShift: {
+                if ((int64_t)b < 0 || b > 63) throw CannotEvaluate();
+                return a << b;
+            }
+            case ASR::binopType::BitRShift: {
+                if ((int64_t)b < 0 || b > 63) throw CannotEvaluate();
+                return (uint64_t)((int64_t)a >> b);
+            }
+            case ASR::binopType::Pow: {
+                if ((int64_t)b < 0) throw CannotEvaluate();
+                uint64_t r = 1;
+                while (b > 0) {
+                    if (b & 1) r *= a;
+                    a *= a;
+                    b >>= 1;
+                }
+                return r;
+            }
+            default:
+                throw CannotEvaluate();
+        }
+    }
+
+    template <class T>
+    static bool compare(ASR::cmpopType op, T a, T b) {
+        switch (op) {
+            case ASR::cmpopType::Eq: return a == b;
+            case ASR::cmpopType::NotEq: return a != b;
+            case ASR::cmpopType::Lt: return a < b;
+            case ASR::cmpopType::LtE: return a <= b;
+            case ASR::cmpopType::Gt: return a > b;
+            case ASR::cmpopType::GtE: return a >= b;
+            default: throw CannotEvaluate();
+        }
+    }
+
+    static Value cast(ASR::cast_kindType kind, const Value &v, ASR::ttype_t *type) {
+        switch (kind) {
+            case ASR::cast_kindType::IntegerToInteger:
+                return integer(wrap(as_integer(v), type));
+            case ASR::cast_kindType::IntegerToReal:
+                return real(round_real((double)as_integer(v), type));
+            case ASR::cast_kindType::RealToReal:
+                return real(round_real(as_real(v), type));
+            case ASR::cast_kindType::RealToInteger: {
+                double r = std::trunc(as_real(v));
+                // Out of range (or NaN) is undefined at run time
+                if (!(r >= -9223372036854775808.0 && r < 9223372036854775808.0)) {
+                    throw CannotEvaluate();
+                }
+                return integer(wrap((int64_t)r, type));
+            }
+            case ASR::cast_kindType::IntegerToLogical:
+                return logical(as_integer(v) != 0);
+            case ASR::cast_kindType::RealToLogical:
+                return logical(as_real(v) != 0);
+            case ASR::cast_kindType::LogicalToInteger:
+                return integer(as_logical(v) ? 1 : 0);
+            case ASR::cast_kindType::LogicalToReal:
+                return real(as_logical(v) ? 1 : 0);
+            default:
+                throw CannotEvaluate();
+        }
+    }
+};
+
+} // namespace LCompilers::LPython
+
+#endif // LPYTHON_SEMANTICS_FUNCTION_EVAL_H
@@ -6,6 +6,7 @@
 #include <libasr/string_utils.h>
 #include <lpython/utils.h>
 #include <lpython/semantics/semantic_exception.h>
+#include <lpython/semantics/static_map.h>
 #include <libasr/asr_utils.h>
 
 namespace LCompilers::LPython {
@@ -15,10 +16,8 @@ struct IntrinsicNodeHandler {
     typedef ASR::asr_t* (*intrinsic_eval_callback)(Allocator &, Vec<ASR::call_arg_t>,
                                         const Location &);
 
-    std::map<std::string, intrinsic_eval_callback> intrinsic_map;
-
-    IntrinsicNodeHandler() {
-        intrinsic_map = {
+    static const auto &intrinsic_map() {
+        static constexpr auto map = make_static_map<intrinsic_eval_callback>({
             {"int", &handle_intrinsic_int},
             {"float", &handle_intrinsic_float},
             {"str", &handle_intrinsic_str},
@@ -27,19 +26,19 @@ struct IntrinsicNodeHandler {
             {"reshape", &handle_reshape},
             {"ord", &handle_intrinsic_ord},
             {"chr", &handle_intrinsic_chr},
-        };
+        });
+        return map;
     }
 
     bool is_present(std::string call_name) {
-        return intrinsic_map.find(call_name) != intrinsic_map.end();
+        return intrinsic_map().contains(call_name);
     }
 
     ASR::asr_t* get_intrinsic_node(std::string call_name,
             Allocator &al, const Location &loc, Vec<ASR::call_arg_t> args) {
-        auto search = intrinsic_map.find(call_name);
-        if (search != intrinsic_map.end()) {
-            intrinsic_eval_callback cb = search->second;
-            return cb(al, args, loc);
+        const intrinsic_eval_callback *cb = intrinsic_map().find(call_name);
+        if (cb) {
+            return (*cb)(al, args, loc);
         } else {
             throw SemanticError(call_name + " is not implemented yet",
                 loc);
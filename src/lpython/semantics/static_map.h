@@ -0,0 +1,136 @@
+#ifndef LPYTHON_SEMANTICS_STATIC_MAP_H
+#define LPYTHON_SEMANTICS_STATIC_MAP_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace LCompilers::LPython {
+
+/*
+    A read-only map from names to `V` (callbacks, other names, ...) that is
+    built by the compiler: the tables of the semantic analysis are constexpr
+    `StaticMap`s, so they cost nothing to construct, for every module
+    compiled, and a lookup hashes the key once and compares at most one
+    entry, without allocating.
+
+    The hash is perfect: the constructor searches for a seed of the hash
+    function that puts every key into its own slot of a table with at least
+    four slots per key (a seed is found after a few tries). A table for which
+    no seed is found, or with duplicate keys, is not a constant expression,
+    i.e., a compile time error.
+
+    Usage:
+
+        static constexpr auto m = make_static_map<int>({{"a", 1}, {"b", 2}});
+        const int *v = m.find("a");
+*/
+
+constexpr uint32_t static_map_hash(std::string_view s, uint32_t seed) {
+    // FNV-1a, with the seed mixed into the offset basis
+    uint32_t h = 2166136261u ^ (seed * 0x9E3779B9u);
+    for (char c: s) {
+        h ^= (unsigned char)c;
+        h *= 16777619u;
+    }
+    return h ^ (h >> 15);
+}
+
+constexpr size_t static_map_slots(size_t n) {
+    size_t m = 8;
+    while (m < 4*n) m *= 2;
+    return m;
+}
+
+// Like std::pair, whose assignment is not constexpr before C++20
+template <class V>
+struct StaticMapEntry {
+    std::string_view first;
+    V second;
+};
+
+template <class V, size_t N>
+class StaticMap
+{
+public:
+    typedef StaticMapEntry<V> value_type;
+    static constexpr size_t n_slots = static_map_slots(N);
+    static constexpr uint32_t max_seed = 10000;
+
+    constexpr StaticMap(const value_type (&entries)[N])
+            : entries{}, slots{}, seed{0} {
+        for (size_t i = 0; i < N; i++) {
+            for (size_t j = 0; j < i; j++) {
+                if (entries[j].first == entries[i].first) {
+                    throw "StaticMap: duplicate key";
+                }
+            }
+            this->entries[i] = entries[i];
+        }
+        while (!try_seed()) {
+            seed++;
+            // Throwing is not allowed in a constant expression: no seed
+            // (like a duplicate key) stops the compilation here
+            if (seed == max_seed) throw "StaticMap: no perfect hash found";
+        }
+    }
+
+    // Returns nullptr if `key` is not in the map
+    constexpr const V *find(std::string_view key) const {
+        uint16_t i = slots[static_map_hash(key, seed) & (n_slots - 1)];
+        if (i == 0 || entries[i-1].first != key) return nullptr;
+        return &entries[i-1].second;
+    }
+
+    constexpr bool contains(std::string_view key) const {
+        return find(key) != nullptr;
+    }
+
+    constexpr size_t size() const {
+        return N;
+    }
+
+    constexpr const value_type *begin() const {
+        return &entries[0];
+    }
+
+    constexpr const value_type *end() const {
+        return &entries[0] + N;
+    }
+
+private:
+    std::array<value_type, N> entries;
+    // The index + 1 of the entry of each slot, 0 if empty
+    std::array<uint16_t, n_slots> slots;
+    uint32_t seed;
+
+    constexpr bool try_seed() {
+        for (size_t j = 0; j < n_slots; j++) slots[j] = 0;
+        for (size_t i = 0; i < N; i++) {
+            size_t j = static_map_hash(entries[i].first, seed) & (n_slots - 1);
+            if (slots[j] != 0) return false;
+            slots[j] = (uint16_t)(i + 1);
+        }
+        return true;
+    }
+};
+
+template <class V, size_t N>
+constexpr StaticMap<V, N> make_static_map(
+        const StaticMapEntry<V> (&entries)[N]) {
+    return StaticMap<V, N>(entries);
+}
+
+// A set of names is a map to `true`
+template <size_t N>
+constexpr StaticMap<bool, N> make_static_set(
+        const std::string_view (&keys)[N]) {
+    StaticMapEntry<bool> entries[N] = {};
+    for (size_t i = 0; i < N; i++) entries[i] = {keys[i], true};
+    return StaticMap<bool, N>(entries);
+}
+
+} // namespace LCompilers::LPython
+
+#endif // LPYTHON_SEMANTICS_STATIC_MAP_H
@@ -0,0 +1,489 @@
+/*
+    Micro-benchmarks of the front end: the tokenizer (`LPython::tokens`), the
+    parser (`LPython::parse`), the semantic analysis (`python_ast_to_asr`) and
+    the interactive compiler (`PythonCompiler::evaluate2`).
+
+    Every stage runs over a corpus of files (by default the `.py` files of
+    `integration_tests/` and `tests/`). One sample is the time to process the
+    whole corpus once; after `--warmup` unmeasured passes, `--repeat` samples
+    are taken and their minimum, percentiles and maximum are reported, with
+    the throughput at the median. Only the stage itself is timed: the input
+    of a stage (e.g. the AST for `python_ast_to_asr`) is prepared outside of
+    the measured region. Files that fail a stage (the tests of errors, ...)
+    are left out of that stage.
+
+    `evaluate2` runs a REPL session: the cells of `--eval-file` files (one
+    file is one cell), or a built-in session of definitions and expressions.
+
+    The `setup` stage measures the per module cost of the semantic analysis
+    that does not depend on the input: the dispatch tables (intrinsics,
+    attributes, compile time evaluation) every module's visitor sets up.
+
+    Usage:
+
+        bench_frontend [--warmup N] [--repeat N] [--stage S]... [--json FILE]
+            [corpus (directory or .py file)]...
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <bin/CLI11.hpp>
+
+#include <libasr/config.h>
+#include <libasr/diagnostics.h>
+#include <libasr/location.h>
+#include <libasr/utils.h>
+#include <lpython/parser/parser.h>
+#include <lpython/parser/source_buffer.h>
+#include <lpython/parser/tokenizer.h>
+#include <lpython/semantics/python_ast_to_asr.h>
+#include <lpython/semantics/python_attribute_eval.h>
+#include <lpython/semantics/python_comptime_eval.h>
+#include <lpython/semantics/python_intrinsic_eval.h>
+#include <lpython/utils.h>
+
+#ifdef HAVE_LFORTRAN_LLVM
+#include <lpython/python_evaluator.h>
+#endif
+
+using LCompilers::Allocator;
+using LCompilers::CompilerOptions;
+using LCompilers::LocationManager;
+using LCompilers::LPython::SourceBuffer;
+namespace diag = LCompilers::diag;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct SourceFile {
+    std::string filename;
+    std::string text;
+    std::unique_ptr<SourceBuffer> source;
+};
+
+struct Corpus {
+    std::string name;
+    std::vector<SourceFile> files;
+};
+
+// The statistics of the samples (seconds) of one stage on one corpus
+struct Measurement {
+    std::string stage;
+    std::string corpus;
+    size_t files = 0;
+    size_t bytes = 0;
+    std::vector<double> samples;
+
+    double percentile(double p) const {
+        std::vector<double> s = samples;
+        std::sort(s.begin(), s.end());
+        // Nearest rank
+        size_t rank = (size_t)std::ceil(p / 100 * s.size());
+        return s[std::max(rank, (size_t)1) - 1];
+    }
+
+    double mean() const {
+        double sum = 0;
+        for (double t: samples) sum += t;
+        return sum / samples.size();
+    }
+};
+
+bool load_file(const std::string &filename, SourceFile &f) {
+    f.filename = filename;
+    if (!LCompilers::read_file(filename, f.text)) return false;
+    f.source = std::make_unique<SourceBuffer>();
+    f.source->load_string(f.text);
+    return true;
+}
+
+// A directory (its `.py` files, sorted by name) or a single file
+bool load_corpus(const std::string &path, Corpus &corpus) {
+    namespace fs = std::filesystem;
+    corpus.name = fs::path(path).filename().string();
+    if (corpus.name.empty()) {
+        corpus.name = fs::path(path).parent_path().filename().string();
+    }
+    std::vector<std::string> filenames;
+    std::error_code ec;
+    if (fs::is_directory(path, ec)) {
+        for (auto &entry: fs::directory_iterator(path, ec)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".py") {
+                filenames.push_back(entry.path().string());
+            }
+        }
+        std::sort(filenames.begin(), filenames.end());
+    } else {
+        filenames.push_back(path);
+    }
+    for (auto &filename: filenames) {
+        SourceFile f;
+        if (!load_file(filename, f)) {
+            std::cerr << "Cannot read '" << filename << "'" << std::endl;
+            return false;
+        }
+        corpus.files.push_back(std::move(f));
+    }
+    return true;
+}
+
+/*
+    A stage processes one file: it returns false if the file fails the stage,
+    and adds the time of the measured part to `time`.
+*/
+typedef std::function<bool(const SourceFile &, double &time)> Stage;
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+bool run_tokens(const SourceFile &f, double &time) {
+    Allocator al(64*1024);
+    diag::Diagnostics diagnostics;
+    auto start = Clock::now();
+    auto r = LCompilers::LPython::tokens(al, f.text, diagnostics);
+    time += seconds_since(start);
+    return r.ok;
+}
+
+bool run_parse(const SourceFile &f, double &time) {
+    Allocator al(64*1024);
+    diag::Diagnostics diagnostics;
+    auto start = Clock::now();
+    auto r = LCompilers::LPython::parse(al, *f.source, 0, diagnostics);
+    time += seconds_since(start);
+    return r.ok;
+}
+
+bool run_asr(CompilerOptions &compiler_options, const SourceFile &f,
+        double &time) {
+    Allocator al(64*1024);
+    diag::Diagnostics diagnostics;
+    LocationManager lm;
+    LocationManager::FileLocations fl;
+    fl.in_filename = f.filename;
+    lm.files.push_back(fl);
+    f.source->init_location_manager(lm);
+    lm.file_ends.push_back(f.source->size());
+    auto ast = LCompilers::LPython::parse(al, *f.source, 0, diagnostics);
+    if (!ast.ok) return false;
+    auto start = Clock::now();
+    auto r = LCompilers::LPython::python_ast_to_asr(al, lm, nullptr,
+        ast.result->base.base, diagnostics,
+        compiler_options, true, "__main__", f.filename);
+    time += seconds_since(start);
+    return r.ok;
+}
+
+// The handlers a `CommonVisitor` has, set up for `setup_count` modules, with
+// a lookup in each
+const size_t setup_count = 1000;
+
+bool run_setup(const SourceFile &, double &time) {
+    bool ok = true;
+    std::string module = "numpy", function = "empty";
+    auto start = Clock::now();
+    for (size_t i = 0; i < setup_count; i++) {
+        LCompilers::LPython::PythonIntrinsicProcedures intrinsic_procedures;
+        LCompilers::LPython::ProceduresDatabase procedures_db;
+        LCompilers::LPython::AttributeHandler attr_handler;
+        LCompilers::LPython::IntrinsicNodeHandler intrinsic_node_handler;
+        (void)attr_handler;
+        ok = ok && intrinsic_procedures.is_intrinsic("divmod")
+            && procedures_db.is_function_to_be_ignored(module, function)
+            && intrinsic_node_handler.is_present("len");
+    }
+    time += seconds_since(start);
+    return ok;
+}
+
+// Runs `stage` over `corpus`. The first pass finds the files that fail the
+// stage, they are not used afterwards; it counts as one of the warm-up passes.
+Measurement run_stage(const std::string &name, const Corpus &corpus,
+        const Stage &stage, size_t warmup, size_t repeat) {
+    Measurement result;
+    result.stage = name;
+    result.corpus = corpus.name;
+    std::vector<const SourceFile *> files;
+    double time = 0;
+    for (auto &f: corpus.files) {
+        if (stage(f, time)) {
+            files.push_back(&f);
+            result.bytes += f.text.size();
+        }
+    }
+    result.files = files.size();
+    for (size_t i = 1; i < warmup; i++) {
+        for (auto f: files) stage(*f, time);
+    }
+    while (result.samples.size() < repeat) {
+        time = 0;
+        for (auto f: files) stage(*f, time);
+        result.samples.push_back(time);
+    }
+    return result;
+}
+
+#ifdef HAVE_LFORTRAN_LLVM
+
+// Definitions followed by the expressions that use them, as typed at the
+// REPL (the same kinds of cells as the `PythonCompiler` tests)
+const std::vector<std::string> default_session = {
+    "1",
+    "1 + 2",
+    "4 // 2",
+    "4 / 2",
+    "3 ** 3",
+    "i64(3) ** i64(3)",
+    R"(
+def addi(x: i32, y: i32) -> i32:
+    return x + y
+)",
+    R"(
+def subi(x: i32, y: i32) -> i32:
+    return addi(x, -y)
+)",
+    "addi(2, 3)",
+    "subi(2, 3)",
+    R"(
+def addr(x: f64, y: f64) -> f64:
+    return x + y
+)",
+    "addr(2.5, 3.5)",
+    R"(
+def fib(n: i32) -> i32:
+    if n < 2:
+        return n
+    return fib(n - 1) + fib(n - 2)
+)",
+    "fib(10)",
+    R"(
+def total(n: i32) -> i32:
+    s: i32 = 0
+    k: i32
+    for k in range(n):
+        s += k
+    return s
+)",
+    "total(100)",
+};
+
+// One sample is a whole session in a new `PythonCompiler`, only the
+// `evaluate2` calls are timed
+bool run_session(const std::vector<std::string> &cells, double &time) {
+    CompilerOptions cu;
+    cu.po.disable_main = true;
+    cu.emit_debug_line_column = false;
+    cu.separate_compilation = false;
+    cu.interactive = true;
+    cu.po.runtime_library_dir = LCompilers::LPython::get_runtime_library_dir();
+    LCompilers::PythonCompiler e(cu);
+    for (auto &cell: cells) {
+        auto start = Clock::now();
+        auto r = e.evaluate2(cell);
+        time += seconds_since(start);
+        if (!r.ok) {
+            std::cerr << "evaluate2 failed on:" << std::endl << cell
+                << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif
+
+std::string format_time(double t) {
+    std::stringstream out;
+    out << std::fixed;
+    if (t < 1e-3) {
+        out << std::setprecision(1) << t * 1e6 << "us";
+    } else if (t < 1) {
+        out << std::setprecision(2) << t * 1e3 << "ms";
+    } else {
+        out << std::setprecision(3) << t << "s";
+    }
+    return out.str();
+}
+
+void print_results(const std::vector<Measurement> &results) {
+    std::cout << std::left << std::setw(10) << "stage"
+        << std::setw(20) << "corpus" << std::right
+        << std::setw(7) << "files"
+        << std::setw(11) << "min" << std::setw(11) << "p50"
+        << std::setw(11) << "p90" << std::setw(11) << "p99"
+        << std::setw(11) << "max" << std::setw(11) << "MB/s" << std::endl;
+    for (auto &r: results) {
+        double p50 = r.percentile(50);
+        std::stringstream throughput;
+        throughput << std::fixed << std::setprecision(1)
+            << (p50 > 0 ? r.bytes / p50 / (1024*1024) : 0);
+        std::cout << std::left << std::setw(10) << r.stage
+            << std::setw(20) << r.corpus << std::right
+            << std::setw(7) << r.files
+            << std::setw(11) << format_time(r.percentile(0))
+            << std::setw(11) << format_time(p50)
+            << std::setw(11) << format_time(r.percentile(90))
+            << std::setw(11) << format_time(r.percentile(99))
+            << std::setw(11) << format_time(r.percentile(100))
+            << std::setw(11) << throughput.str() << std::endl;
+    }
+}
+
+std::string results_to_json(const std::vector<Measurement> &results,
+        size_t warmup, size_t repeat) {
+    using LCompilers::LPython::json_string;
+    std::stringstream out;
+    out << "{\"warmup\": " << warmup << ", \"repeat\": " << repeat
+        << ", \"results\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Measurement &r = results[i];
+        double p50 = r.percentile(50);
+        if (i > 0) out << ", ";
+        out << "{\"stage\": " << json_string(r.stage)
+            << ", \"corpus\": " << json_string(r.corpus)
+            << ", \"files\": " << r.files
+            << ", \"bytes\": " << r.bytes
+            << ", \"min_ms\": " << r.percentile(0) * 1e3
+            << ", \"p50_ms\": " << p50 * 1e3
+            << ", \"p90_ms\": " << r.percentile(90) * 1e3
+            << ", \"p99_ms\": " << r.percentile(99) * 1e3
+            << ", \"max_ms\": " << r.percentile(100) * 1e3
+            << ", \"mean_ms\": " << r.mean() * 1e3
+            << ", \"bytes_per_s\": " << (p50 > 0 ? r.bytes / p50 : 0)
+            << ", \"samples_ms\": [";
+        for (size_t j = 0; j < r.samples.size(); j++) {
+            if (j > 0) out << ", ";
+            out << r.samples[j] * 1e3;
+        }
+        out << "]}";
+    }
+    out << "]}";
+    return out.str();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    size_t warmup = 3;
+    size_t repeat = 20;
+    std::vector<std::string> stages;
+    std::vector<std::string> corpora;
+    std::vector<std::string> eval_files;
+    std::string json_file;
+
+    CLI::App app{"LPython front-end micro-benchmarks"};
+    app.add_option("corpus", corpora, "Directories (their .py files) or files to benchmark on; the integration_tests and tests directories by default");
+    app.add_option("--warmup", warmup, "Unmeasured passes over each corpus")->capture_default_str();
+    app.add_option("--repeat", repeat, "Measured passes over each corpus")->capture_default_str();
+    app.add_option("--stage", stages, "Only run this stage (tokens, parse, asr, evaluate, setup)");
+    app.add_option("--eval-file", eval_files, "A cell of the session of the evaluate stage (the cells are evaluated in order)");
+    app.add_option("--json", json_file, "Also write the results and all samples to this file");
+    CLI11_PARSE(app, argc, argv);
+
+    if (repeat == 0) repeat = 1;
+    if (stages.empty()) stages = {"setup", "tokens", "parse", "asr", "evaluate"};
+    for (auto &stage: stages) {
+        if (stage != "tokens" && stage != "parse" && stage != "asr"
+                && stage != "evaluate" && stage != "setup") {
+            std::cerr << "Unknown stage '" << stage << "'" << std::endl;
+            return 1;
+        }
+    }
+    if (corpora.empty()) {
+        corpora = {LPYTHON_SOURCE_DIR "/integration_tests",
+            LPYTHON_SOURCE_DIR "/tests"};
+    }
+
+    std::vector<Corpus> corpus_list;
+    for (auto &path: corpora) {
+        Corpus corpus;
+        if (!load_corpus(path, corpus)) return 1;
+        corpus_list.push_back(std::move(corpus));
+    }
+
+    CompilerOptions compiler_options;
+    compiler_options.po.runtime_library_dir
+        = LCompilers::LPython::get_runtime_library_dir();
+    // The diagnostics of the files that fail a stage are not printed
+    std::vector<Measurement> results;
+    for (auto &stage: stages) {
+        if (stage == "evaluate") continue;
+        if (stage == "setup") {
+            Corpus modules;
+            modules.name = std::to_string(setup_count) + " modules";
+            modules.files.emplace_back();
+            results.push_back(run_stage(stage, modules, run_setup, warmup,
+                repeat));
+            continue;
+        }
+        Stage run;
+        if (stage == "tokens") {
+            run = run_tokens;
+        } else if (stage == "parse") {
+            run = run_parse;
+        } else {
+            run = [&](const SourceFile &f, double &time) {
+                return run_asr(compiler_options, f, time);
+            };
+        }
+        for (auto &corpus: corpus_list) {
+            results.push_back(run_stage(stage, corpus, run, warmup, repeat));
+        }
+    }
+
+    if (std::find(stages.begin(), stages.end(), "evaluate") != stages.end()) {
+#ifdef HAVE_LFORTRAN_LLVM
+        Corpus session;
+        session.name = eval_files.empty() ? "session" : "eval-files";
+        std::vector<std::string> cells;
+        if (eval_files.empty()) {
+            cells = default_session;
+        } else {
+            for (auto &filename: eval_files) {
+                SourceFile f;
+                if (!load_file(filename, f)) {
+                    std::cerr << "Cannot read '" << filename << "'" << std::endl;
+                    return 1;
+                }
+                cells.push_back(f.text);
+            }
+        }
+        // The whole session is one "file" of the corpus
+        SourceFile all;
+        for (auto &cell: cells) all.text += cell;
+        session.files.push_back(std::move(all));
+        results.push_back(run_stage("evaluate", session,
+            [&](const SourceFile &, double &time) {
+                return run_session(cells, time);
+            }, warmup, repeat));
+        if (results.back().files == 0) return 1;
+#else
+        std::cerr << "The evaluate stage requires LLVM, skipped" << std::endl;
+#endif
+    }
+
+    print_results(results);
+    if (!json_file.empty()) {
+        std::ofstream out(json_file);
+        out << results_to_json(results, warmup, repeat) << std::endl;
+        if (!out) {
+            std::cerr << "Cannot write '" << json_file << "'" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
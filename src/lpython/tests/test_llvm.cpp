@@ -2,18 +2,37 @@
 
 #include <cmath>
 #include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
 
 #include <lpython/python_evaluator.h>
 #include <libasr/codegen/evaluator.h>
 #include <libasr/exception.h>
 #include <libasr/asr.h>
+#include <libasr/asr_utils.h>
 #include <libasr/codegen/asr_to_llvm.h>
 #include <lpython/pickle.h>
+#include <lpython/semantics/python_ast_to_asr.h>
+#include <lpython/pgo.h>
+#include <lpython/multiversion.h>
+
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/GlobalIFunc.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Support/SourceMgr.h>
 
 using LCompilers::TRY;
 using LCompilers::PythonCompiler;
 using LCompilers::CompilerOptions;
 
+// Defined in test_serialization.cpp
+std::filesystem::path make_temp_dir(const std::string &prefix);
+
 
 TEST_CASE("llvm 1") {
     //std::cout << "LLVM Version:" << std::endl;
@@ -1915,3 +1934,275 @@ def subr(x: f64, y: f64) -> f64:
     CHECK(r.result.type == PythonCompiler::EvalResult::real8);
     CHECK(r.result.f64 == -1);
 }
+
+TEST_CASE("PythonCompiler overload cache") {
+    CompilerOptions cu;
+    cu.po.disable_main = true;
+    cu.emit_debug_line_column = false;
+    cu.separate_compilation = false;
+    cu.interactive = true;
+    cu.po.runtime_library_dir = LCompilers::LPython::get_runtime_library_dir();
+    PythonCompiler e(cu);
+    LCompilers::LPython::OverloadCacheStats before
+        = LCompilers::LPython::get_overload_cache_stats();
+    LCompilers::Result<PythonCompiler::EvalResult>
+
+    // Two argument signatures: the later calls with the same types take the
+    // overload selected by the first one from the cache
+    r = e.evaluate2(R"(
+from lpython import overload, i32, f64
+
+@overload
+def f(x: i32) -> i32:
+    return x + 1
+
+@overload
+def f(x: f64) -> i32:
+    return 10
+
+def g() -> i32:
+    return f(1) + f(2.0) + f(3) + f(4.0) + f(5)
+)");
+    CHECK(r.ok);
+    CHECK(r.result.type == PythonCompiler::EvalResult::none);
+    LCompilers::LPython::OverloadCacheStats after
+        = LCompilers::LPython::get_overload_cache_stats();
+    CHECK(after.misses - before.misses >= 2);
+    CHECK(after.hits - before.hits >= 3);
+    // The cached selections call the right overloads
+    r = e.evaluate2("g()");
+    CHECK(r.ok);
+    CHECK(r.result.type == PythonCompiler::EvalResult::integer4);
+    CHECK(r.result.i32 == 2 + 10 + 4 + 10 + 6);
+}
+
+// The compile time value of each call in the ASR, by the called function
+class FunctionCallValues : public LCompilers::ASR::BaseWalkVisitor<FunctionCallValues>
+{
+public:
+    std::map<std::string, LCompilers::ASR::expr_t*> values;
+
+    void visit_FunctionCall(const LCompilers::ASR::FunctionCall_t &x) {
+        values[LCompilers::ASRUtils::symbol_name(x.m_name)] = x.m_value;
+        LCompilers::ASR::BaseWalkVisitor<FunctionCallValues>::visit_FunctionCall(x);
+    }
+};
+
+TEST_CASE("PythonCompiler compile time evaluation of calls") {
+    std::string source = R"(
+from lpython import i32, i64
+
+def mask(bits: i32) -> i64:
+    m: i64 = i64(0)
+    i: i32
+    for i in range(bits):
+        m = m | (i64(1) << i64(i))
+    return m
+
+def spin(n: i32) -> i32:
+    s: i32 = 0
+    i: i32
+    for i in range(n):
+        s = (s + i) % 1000
+    return s
+
+def f() -> i64:
+    return mask(12) + i64(spin(1000000))
+)";
+    auto call_values = [&](bool fast) {
+        CompilerOptions cu;
+        cu.po.disable_main = true;
+        cu.emit_debug_line_column = false;
+        cu.separate_compilation = false;
+        cu.po.runtime_library_dir = LCompilers::LPython::get_runtime_library_dir();
+        cu.po.fast = fast;
+        PythonCompiler e(cu);
+        LCompilers::LocationManager lm;
+        LCompilers::diag::Diagnostics diagnostics;
+        LCompilers::Result<LCompilers::ASR::TranslationUnit_t*>
+            r = e.get_asr2(source, lm, diagnostics);
+        REQUIRE(r.ok);
+        FunctionCallValues v;
+        v.visit_TranslationUnit(*r.result);
+        REQUIRE(v.values.count("mask") == 1);
+        REQUIRE(v.values.count("spin") == 1);
+        return v.values;
+    };
+
+    // With --fast the call is replaced by its value, the call that runs out
+    // of fuel is left to run time
+    std::map<std::string, LCompilers::ASR::expr_t*> values = call_values(true);
+    REQUIRE(values["mask"] != nullptr);
+    REQUIRE(LCompilers::ASR::is_a<LCompilers::ASR::IntegerConstant_t>(*values["mask"]));
+    CHECK(LCompilers::ASR::down_cast<LCompilers::ASR::IntegerConstant_t>(
+        values["mask"])->m_n == 4095);
+    CHECK(values["spin"] == nullptr);
+
+    // Not evaluated otherwise
+    values = call_values(false);
+    CHECK(values["mask"] == nullptr);
+    CHECK(values["spin"] == nullptr);
+}
+
+TEST_CASE("PythonCompiler time report") {
+    CompilerOptions cu;
+    cu.po.disable_main = true;
+    cu.emit_debug_line_column = false;
+    cu.separate_compilation = false;
+    cu.interactive = true;
+    cu.po.runtime_library_dir = LCompilers::LPython::get_runtime_library_dir();
+    PythonCompiler e(cu);
+    LCompilers::LPython::CompilationReport report;
+    e.report = &report;
+    LCompilers::Result<PythonCompiler::EvalResult>
+    r = e.evaluate2("2 + 3");
+    CHECK(r.ok);
+    CHECK(r.result.type == PythonCompiler::EvalResult::integer4);
+    CHECK(r.result.i32 == 5);
+    CHECK(e.compiler_options.po.verbose == false);
+    CHECK(report.times.size() >= 1);
+    CHECK(report.times[0].first == "ASR passes + LLVM IR generation");
+    REQUIRE(report.asr_nodes.size() == 2);
+    CHECK(report.asr_nodes[0].second.total() > 0);
+    CHECK(report.asr_nodes[1].second.total() > 0);
+    CHECK(LCompilers::LPython::time_report_to_json(report).find("\"asr_nodes\": [") != std::string::npos);
+}
+
+TEST_CASE("profile guided optimization") {
+    std::string ir = R"""(
+define i32 @f(i32 %x) {
+entry:
+    %c = icmp sgt i32 %x, 7
+    br i1 %c, label %big, label %small
+big:
+    ret i32 1
+small:
+    ret i32 0
+}
+
+define i32 @g() {
+    ret i32 3
+}
+    )""";
+    llvm::LLVMContext context;
+    llvm::SMDiagnostic err;
+    std::unique_ptr<llvm::Module> m = llvm::parseAssemblyString(ir, err, context);
+    REQUIRE(m);
+    LCompilers::LPython::instrument_module(*m);
+    CHECK(m->getGlobalVariable("__lpython_prof_counters", true) != nullptr);
+    CHECK(m->getFunction("__lpython_prof_write") != nullptr);
+
+    // Two runs of the instrumented executable
+    std::filesystem::path tmp = make_temp_dir("lpython_profile_test");
+    std::string filename = (tmp / "test_llvm_profile.prof").string();
+    {
+        std::ofstream out(filename);
+        out << "LPython profile 1\nfn 10 1 f\n2 8\nfn 0 0 g\n";
+        out << "LPython profile 1\nfn 10 1 f\n2 8\nfn 0 0 g\n";
+    }
+    m = llvm::parseAssemblyString(ir, err, context);
+    REQUIRE(m);
+    std::string error;
+    CHECK(LCompilers::LPython::apply_profile(*m, filename, error));
+    llvm::Function *f = m->getFunction("f");
+    CHECK(f->getEntryCount()->getCount() == 20);
+    CHECK(f->getEntryBlock().getTerminator()->getMetadata(llvm::LLVMContext::MD_prof) != nullptr);
+    CHECK(m->getFunction("g")->hasFnAttribute(llvm::Attribute::Cold));
+
+    CHECK(!LCompilers::LPython::apply_profile(*m,
+        (tmp / "does_not_exist.prof").string(), error));
+    std::filesystem::remove_all(tmp);
+}
+
+TEST_CASE("function multiversioning") {
+#if LLVM_VERSION_MAJOR >= 15
+    std::string ptr = "ptr";
+#else
+    std::string ptr = "double*";
+#endif
+    // `sum` and `twice` loop over an array, `g` does not
+    std::string ir = R"""(
+define double @sum()""" + ptr + R"""( %a, i64 %n) {
+entry:
+    br label %loop
+loop:
+    %i = phi i64 [0, %entry], [%i1, %loop]
+    %s = phi double [0.0, %entry], [%s1, %loop]
+    %p = getelementptr double, )""" + ptr + R"""( %a, i64 %i
+    %x = load double, )""" + ptr + R"""( %p
+    %s1 = fadd double %s, %x
+    %i1 = add i64 %i, 1
+    %c = icmp slt i64 %i1, %n
+    br i1 %c, label %loop, label %exit
+exit:
+    ret double %s1
+}
+
+define double @twice()""" + ptr + R"""( %a, i64 %n) {
+entry:
+    br label %loop
+loop:
+    %i = phi i64 [0, %entry], [%i1, %loop]
+    %p = getelementptr double, )""" + ptr + R"""( %a, i64 %i
+    store double 1.0, )""" + ptr + R"""( %p
+    %i1 = add i64 %i, 1
+    %c = icmp slt i64 %i1, %n
+    br i1 %c, label %loop, label %exit
+exit:
+    %s = call double @sum()""" + ptr + R"""( %a, i64 %n)
+    %r = fmul double %s, 2.0
+    ret double %r
+}
+
+define i32 @g(i32 %x) {
+    %y = add i32 %x, 1
+    ret i32 %y
+}
+    )""";
+    llvm::LLVMContext context;
+    llvm::SMDiagnostic err;
+    std::unique_ptr<llvm::Module> m = llvm::parseAssemblyString(ir, err, context);
+    REQUIRE(m);
+    std::string error;
+    REQUIRE(LCompilers::LPython::multiversion_module(*m, {"avx2", "avx512"},
+        "x86_64-unknown-linux-gnu", error));
+    CHECK(!llvm::verifyModule(*m, &llvm::errs()));
+
+    // The functions with array loops are dispatched through an ifunc to a
+    // clone per ISA level, or to the original one
+    for (std::string name: {"sum", "twice"}) {
+        CHECK(m->getNamedIFunc(name) != nullptr);
+        CHECK(m->getFunction(name + ".default") != nullptr);
+        llvm::Function *avx2 = m->getFunction(name + ".avx2");
+        llvm::Function *avx512 = m->getFunction(name + ".avx512");
+        REQUIRE(avx2 != nullptr);
+        REQUIRE(avx512 != nullptr);
+        CHECK(avx2->getFnAttribute("target-features").getValueAsString().str()
+            .find("+avx2") != std::string::npos);
+        CHECK(avx512->getFnAttribute("target-features").getValueAsString().str()
+            .find("+avx512f") != std::string::npos);
+    }
+    CHECK(m->getNamedIFunc("g") == nullptr);
+    CHECK(m->getFunction("g") != nullptr);
+
+    // A clone calls the clone of the same level directly
+    bool calls_sum_avx2 = false;
+    for (auto &bb: *m->getFunction("twice.avx2")) {
+        for (auto &inst: bb) {
+            auto call = llvm::dyn_cast<llvm::CallBase>(&inst);
+            if (call && call->getCalledFunction() == m->getFunction("sum.avx2")) {
+                calls_sum_avx2 = true;
+            }
+        }
+    }
+    CHECK(calls_sum_avx2);
+
+    m = llvm::parseAssemblyString(ir, err, context);
+    REQUIRE(m);
+    CHECK(!LCompilers::LPython::multiversion_module(*m, {"sse9"},
+        "x86_64-unknown-linux-gnu", error));
+    CHECK(!LCompilers::LPython::multiversion_module(*m, {"avx2"},
+        "x86_64-apple-darwin", error));
+    CHECK(!LCompilers::LPython::multiversion_module(*m, {"avx2"},
+        "aarch64-unknown-linux-gnu", error));
+}
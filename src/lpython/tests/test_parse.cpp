@@ -3,9 +3,19 @@
 #include <iostream>
 #include <sstream>
 #include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
 #include <string>
+#include <vector>
 
 #include <lpython/bigint.h>
+#include <lpython/pickle.h>
+#include <lpython/parser/parser.h>
+#include <lpython/parser/source_buffer.h>
+#include <lpython/parser/tokenizer_simd.h>
+#include <lpython/semantics/static_map.h>
 
 using LCompilers::TRY;
 using LCompilers::Result;
@@ -18,6 +28,9 @@ using LCompilers::LPython::BigInt::largeint_to_string;
 using LCompilers::LPython::BigInt::MAX_SMALL_INT;
 using LCompilers::LPython::BigInt::MIN_SMALL_INT;
 
+// Defined in test_serialization.cpp
+std::filesystem::path make_temp_dir(const std::string &prefix);
+
 // Print any vector like iterable to a string
 template <class T>
 inline std::ostream &print_vec(std::ostream &out, T &d)
@@ -102,19 +115,79 @@ TEST_CASE("Test Big Int") {
     /* Big int tests */
     Allocator al(1024);
     LCompilers::Str s;
-    char *cs;
+    std::string cs;
 
     s.from_str(al, "123");
     i = string_to_largeint(al, s);
     CHECK(is_int_ptr(i));
     cs = largeint_to_string(i);
-    CHECK(std::string(cs) == "123");
+    CHECK(cs == "123");
 
     s.from_str(al, "123567890123456789012345678901234567890");
     i = string_to_largeint(al, s);
     CHECK(is_int_ptr(i));
     cs = largeint_to_string(i);
-    CHECK(std::string(cs) == "123567890123456789012345678901234567890");
+    CHECK(cs == "123567890123456789012345678901234567890");
+}
+
+TEST_CASE("Test Big Int arithmetic") {
+    namespace BigInt = LCompilers::LPython::BigInt;
+    Allocator al(1024);
+    auto dec = [&](const std::string &s) {
+        if (s[0] == '-') return BigInt::neg(al, BigInt::parse_int(al, s.c_str() + 1, s.size() - 1, 10));
+        return BigInt::parse_int(al, s.c_str(), s.size(), 10);
+    };
+    auto str = [](int64_t i) { return BigInt::int_to_str(i); };
+    int64_t i, v;
+
+    // Small results are small ints
+    CHECK(BigInt::parse_int(al, "123", 3, 10) == 123);
+    CHECK(BigInt::parse_int(al, "ff_ff", 5, 16) == 65535);
+    CHECK(BigInt::parse_int(al, "1_0_1", 5, 2) == 5);
+    CHECK(BigInt::parse_int(al, "777", 3, 8) == 511);
+    CHECK(!is_int_ptr(BigInt::sub(al, dec("4611686018427387904"), 1)));
+    CHECK(BigInt::sub(al, dec("4611686018427387904"), 1) == MAX_SMALL_INT);
+
+    i = BigInt::parse_int(al, "ffffffffffffffffffffffffffffffff", 32, 16);
+    CHECK(is_int_ptr(i));
+    CHECK(str(i) == "340282366920938463463374607431768211455");
+    CHECK(str(BigInt::add(al, i, 1)) == "340282366920938463463374607431768211456");
+    CHECK(str(BigInt::neg(al, i)) == "-340282366920938463463374607431768211455");
+
+    CHECK(str(BigInt::mul(al, dec("123456789012345678901234567890"),
+        dec("-987654321098765432109876543210")))
+        == "-121932631137021795226185032733622923332237463801111263526900");
+    CHECK(str(BigInt::pow(al, 2, 100)) == "1267650600228229401496703205376");
+    CHECK(str(BigInt::pow(al, -3, 41)) == "-36472996377170786403");
+    CHECK(str(BigInt::lshift(al, 1, 64)) == "18446744073709551616");
+    CHECK(BigInt::rshift(al, BigInt::lshift(al, 5, 100), 100) == 5);
+    CHECK(BigInt::rshift(al, dec("-18446744073709551617"), 64) == -2);
+
+    // Python's floor division and modulo
+    i = BigInt::pow(al, 2, 100);
+    CHECK(BigInt::mod(al, i, 1000000007) == 976371285);
+    CHECK(str(BigInt::floordiv(al, i, dec("-1000000000000"))) == "-1267650600228229402");
+    CHECK(str(BigInt::mod(al, i, dec("-1000000000000"))) == "-503296794624");
+    CHECK(str(BigInt::floordiv(al, dec("-340282366920938463463374607431768211455"),
+        dec("18446744073709551629"))) == "-18446744073709551604");
+    CHECK(str(BigInt::mod(al, dec("-340282366920938463463374607431768211455"),
+        dec("18446744073709551629"))) == "18446744073709551461");
+
+    CHECK(BigInt::compare(i, BigInt::add(al, i, 1)) == -1);
+    CHECK(BigInt::compare(BigInt::neg(al, i), 5) == -1);
+    CHECK(BigInt::bit_length(i) == 101);
+
+    CHECK(BigInt::to_int64(dec("9223372036854775807"), v));
+    CHECK(v == 9223372036854775807LL);
+    CHECK(!BigInt::to_int64(dec("9223372036854775808"), v));
+    CHECK(!BigInt::to_int64(dec("-9223372036854775809"), v));
+
+    CHECK(BigInt::to_double(-5) == -5.0);
+    CHECK(BigInt::to_double(BigInt::pow(al, 2, 70)) == 1180591620717411303424.0);
+    CHECK(BigInt::to_double(BigInt::neg(al, BigInt::pow(al, 2, 64))) == -18446744073709551616.0);
+    // 2^64 + 2^11 + 1 rounds up: the 1 is below the top 64 bits
+    CHECK(BigInt::to_double(dec("18446744073709553665")) == 18446744073709555712.0);
+    CHECK(std::isinf(BigInt::to_double(BigInt::pow(al, 10, 400))));
 }
 
 TEST_CASE("Test LCompilers::Vec") {
@@ -295,3 +368,227 @@ TEST_CASE("Test LCompilers::Allocator 2") {
     // Must manually call the destructor:
     v->~vector<int>();
 }
+
+TEST_CASE("Test LCompilers::LPython::SourceBuffer") {
+    using LCompilers::LPython::SourceBuffer;
+    auto check_padding = [](const SourceBuffer &b) {
+        CHECK(b.data()[b.text_size()-1] == '\n');
+        for (size_t i = 0; i <= SourceBuffer::padding; i++) {
+            CHECK(b.data()[b.text_size()+i] == '\0');
+        }
+    };
+    SourceBuffer b;
+
+    // A newline is added if missing
+    b.load_string("x = 1");
+    CHECK(b.size() == 5);
+    CHECK(b.text_size() == 6);
+    CHECK(std::string(b.data()) == "x = 1\n");
+    check_padding(b);
+
+    b.load_string("x = 1\n");
+    CHECK(b.size() == 6);
+    CHECK(b.text_size() == 6);
+    check_padding(b);
+
+    b.load_string("");
+    CHECK(b.size() == 0);
+    CHECK(std::string(b.data()) == "\n");
+    check_padding(b);
+
+    std::filesystem::path tmp = make_temp_dir("lpython_source_buffer_test");
+    CHECK(!b.load_file((tmp / "nonexistent_file.py").string()));
+
+    // Large files are memory mapped, also if their size is a multiple of
+    // the page size (the padding is then in the following page)
+    std::string filename = (tmp / "test_source_buffer.py").string();
+    std::string line = "print(1)\n";
+    std::string contents;
+    while (contents.size() < 2*SourceBuffer::mmap_threshold) contents += line;
+    contents.resize(32*1024);
+    {
+        std::ofstream out(filename, std::ios::binary);
+        out << contents;
+    }
+    REQUIRE(b.load_file(filename));
+    CHECK(b.size() == contents.size());
+    CHECK(b.text_size() == contents.size() + 1);
+    CHECK(std::string(b.data(), b.size()) == contents);
+    check_padding(b);
+
+    LCompilers::LocationManager lm;
+    lm.files.push_back(LCompilers::LocationManager::FileLocations());
+    b.init_location_manager(lm);
+    CHECK(lm.files.back().in_newlines.size() == contents.size() / line.size());
+    CHECK(lm.files.back().in_newlines[0] == line.size() - 1);
+    // Unmaps the file
+    b.load_string("");
+    std::filesystem::remove_all(tmp);
+}
+
+TEST_CASE("Test the tokenizer fast paths") {
+    namespace simd = LCompilers::LPython::simd;
+    // Returns the offset of the end of the run that starts at `start`. The
+    // input is copied to a buffer of its exact size, so that a read past its
+    // end is caught by the address sanitizer
+    auto run = [](const std::string &s, size_t start,
+            const unsigned char *(*skip)(const unsigned char *,
+                const unsigned char *)) {
+        std::vector<unsigned char> buf(s.begin(), s.end());
+        buf.push_back('\0');
+        const unsigned char *p = buf.data();
+        return (size_t)(skip(p + start, p + s.size()) - p);
+    };
+    auto string_end = [](const std::string &s, size_t start) {
+        std::vector<unsigned char> buf(s.begin(), s.end());
+        buf.push_back('\0');
+        const unsigned char *p = buf.data();
+        const unsigned char *end = simd::skip_string(p + start, p + s.size(),
+            s[start-1]);
+        return end ? (size_t)(end - p) : std::string::npos;
+    };
+    std::string indent(70, ' ');
+
+    CHECK(run("", 0, simd::skip_blanks) == 0);
+    CHECK(run(indent + "x", 0, simd::skip_blanks) == 70);
+    CHECK(run(indent + "\t\v#", 3, simd::skip_blanks) == 72);
+    CHECK(run(indent, 0, simd::skip_blanks) == 70);
+    // Runs that end in the tail, shorter than a block, of every length
+    for (size_t n = 0; n < 70; n++) {
+        CHECK(run(std::string(n, ' '), 0, simd::skip_blanks) == n);
+        CHECK(run(std::string(n, 'x'), 0, simd::skip_name_chars) == n);
+        CHECK(run("#" + std::string(n, 'x'), 0, simd::skip_to_newline) == n + 1);
+    }
+
+    CHECK(run("# " + indent + "\r\nx", 0, simd::skip_to_newline) == 73);
+    CHECK(run("# " + indent, 1, simd::skip_to_newline) == 72);
+
+    std::string name = "a_very_long_identifier_with_digits_0123456789_"
+        "and_\xce\xb1_non_ascii_characters";
+    CHECK(run(name + "(x)", 1, simd::skip_name_chars) == name.size());
+    CHECK(run(name + ".y", 1, simd::skip_name_chars) == name.size());
+    CHECK(run(name, 0, simd::skip_name_chars) == name.size());
+    CHECK(run("x[@`{/:", 0, simd::skip_name_chars) == 1);
+
+    CHECK(string_end("\"\"", 1) == 2);
+    CHECK(string_end("\"" + indent + "\" + 1", 1) == 72);
+    CHECK(string_end("'" + indent + "\\'\"'", 1) == 75);
+    CHECK(string_end("'" + indent + "\\\n'", 1) == 74);
+    CHECK(string_end("'" + indent + "\n'", 1) == std::string::npos);
+    CHECK(string_end("'" + indent + "\\", 1) == std::string::npos);
+    CHECK(string_end("\"" + indent, 1) == std::string::npos);
+}
+
+TEST_CASE("Test LCompilers::LPython::parse_parallel") {
+    using LCompilers::LPython::SourceBuffer;
+    std::string source = "from lpython import i32\n\n";
+    for (size_t i = 0; source.size() < 2*LCompilers::LPython::min_parallel_parse_size; i++) {
+        std::string n = std::to_string(i);
+        source += "@dec" + n + "(1,\n2)\n\n# comment\ndef A" + n + "(x: i32) -> i32:\n"
+            "    s: str = \"\"\"\ndef B" + n + "():\n\"\"\"\n"
+            "    y: i32 = (1 +\ndef_" + n + ")\n"
+            "    return x + y  # comment\n"
+            "class C" + n + ":\n    x: i32 = " + n + "\n";
+    }
+    source += "print(A0(1))\n";
+    SourceBuffer b;
+    b.load_string(source);
+    LCompilers::LocationManager lm;
+    lm.files.push_back(LCompilers::LocationManager::FileLocations());
+    b.init_location_manager(lm);
+    lm.file_ends.push_back(b.size());
+
+    Allocator al(1024*1024);
+    LCompilers::diag::Diagnostics diagnostics;
+    auto sequential = LCompilers::LPython::parse(al, b, 0, diagnostics);
+    REQUIRE(sequential.ok);
+    std::vector<std::unique_ptr<Allocator>> arenas;
+    auto parallel = LCompilers::LPython::parse_parallel(al, arenas, b, 0,
+        diagnostics, 4);
+    REQUIRE(parallel.ok);
+    CHECK(arenas.size() == 3);
+    CHECK(parallel.result->n_body == sequential.result->n_body);
+    CHECK(parallel.result->n_type_ignores == sequential.result->n_type_ignores);
+    CHECK(LCompilers::LPython::pickle_json(
+            *(LCompilers::LPython::AST::ast_t*)parallel.result, lm)
+        == LCompilers::LPython::pickle_json(
+            *(LCompilers::LPython::AST::ast_t*)sequential.result, lm));
+
+    // Errors are reported as by the sequential parser
+    b.load_string(source + "def f(:\n    pass\n");
+    LCompilers::diag::Diagnostics d1, d2;
+    CHECK(!LCompilers::LPython::parse(al, b, 0, d1).ok);
+    CHECK(!LCompilers::LPython::parse_parallel(al, arenas, b, 0, d2, 4).ok);
+    REQUIRE(d1.diagnostics.size() == 1);
+    REQUIRE(d2.diagnostics.size() == 1);
+    CHECK(d1.diagnostics[0].message == d2.diagnostics[0].message);
+}
+
+TEST_CASE("Test LCompilers::LPython::NameInterner") {
+    namespace AST = LCompilers::LPython::AST;
+    Allocator al(4*1024);
+    LCompilers::LPython::NameInterner names;
+    char *a = names.intern(al, "abc", 3);
+    CHECK(std::string(a) == "abc");
+    CHECK(names.intern(al, "abcd", 3) == a);
+    CHECK(names.intern(al, "abd", 3) != a);
+    CHECK(names.intern(al, "", 0) != a);
+    CHECK(names.size() == 3);
+    // Enough names to grow the table several times
+    std::vector<char *> p;
+    for (size_t i = 0; i < 5000; i++) {
+        std::string s = "name_" + std::to_string(i);
+        p.push_back(names.intern(al, s.c_str(), s.size()));
+    }
+    CHECK(names.size() == 5003);
+    for (size_t i = 0; i < 5000; i++) {
+        std::string s = "name_" + std::to_string(i);
+        CHECK(names.intern(al, s.c_str(), s.size()) == p[i]);
+        CHECK(std::string(p[i]) == s);
+    }
+    CHECK(names.intern(al, "abc", 3) == a);
+
+    // All uses of a name in the AST share the interned string
+    LCompilers::diag::Diagnostics diagnostics;
+    auto r = LCompilers::LPython::parse(al, "x = y + x\n", 0, diagnostics);
+    REQUIRE(r.ok);
+    REQUIRE(r.result->n_body == 1);
+    AST::Assign_t *assign = AST::down_cast<AST::Assign_t>(r.result->m_body[0]);
+    AST::BinOp_t *binop = AST::down_cast<AST::BinOp_t>(assign->m_value);
+    char *x1 = AST::down_cast<AST::Name_t>(assign->m_targets[0])->m_id;
+    char *y = AST::down_cast<AST::Name_t>(binop->m_left)->m_id;
+    char *x2 = AST::down_cast<AST::Name_t>(binop->m_right)->m_id;
+    CHECK(std::string(x1) == "x");
+    CHECK(std::string(y) == "y");
+    CHECK(x1 == x2);
+}
+
+TEST_CASE("Test LCompilers::LPython::StaticMap") {
+    using LCompilers::LPython::make_static_map;
+    using LCompilers::LPython::make_static_set;
+    static constexpr auto m = make_static_map<int>({
+        {"a", 1}, {"b", 2}, {"list@append", 3}, {"", 4}});
+    static_assert(m.size() == 4);
+    static_assert(*m.find("b") == 2);
+    static_assert(m.find("c") == nullptr);
+    CHECK(*m.find(std::string("list@append")) == 3);
+    CHECK(*m.find("") == 4);
+    CHECK(!m.contains("list@"));
+    CHECK(!m.contains("ab"));
+    size_t n = 0;
+    for (auto &e: m) {
+        CHECK(m.find(e.first) == &e.second);
+        n++;
+    }
+    CHECK(n == 4);
+
+    // Enough keys that some of them share the hash modulo the table size
+    // for the first seeds
+    static constexpr auto s = make_static_set({"int8", "int16", "int32",
+        "int64", "uint8", "uint16", "uint32", "uint64", "float32", "float64",
+        "complex64", "complex128", "bool", "bool_", "float_", "complex_",
+        "object", "empty", "reshape", "array", "size", "exp", "exp2"});
+    for (auto &e: s) CHECK(s.contains(e.first));
+    CHECK(!s.contains("int"));
+    CHECK(!s.contains("int80"));
+}
@@ -1,9 +1,17 @@
 #include <tests/doctest.h>
 #include <iostream>
+#include <filesystem>
+#include <fstream>
+#include <random>
 
 #include <libasr/bwriter.h>
 #include <libasr/serialization.h>
 #include <lpython/pickle.h>
+#include <lpython/asr_cache.h>
+#include <lpython/ast_cache.h>
+#include <lpython/python_serialization.h>
+#include <lpython/parser/parser.h>
+#include <lpython/utils.h>
 #include <libasr/asr_utils.h>
 #include <libasr/asr_verify.h>
 
@@ -13,6 +21,18 @@ using LCompilers::uint64_to_string;
 using LCompilers::string_to_uint32;
 using LCompilers::uint32_to_string;
 
+// A new empty directory in the system temporary directory, the caller
+// removes it
+std::filesystem::path make_temp_dir(const std::string &prefix) {
+    namespace fs = std::filesystem;
+    std::random_device rd;
+    while (true) {
+        fs::path dir = fs::temp_directory_path()
+            / (prefix + "_" + std::to_string(rd()));
+        if (fs::create_directory(dir)) return dir;
+    }
+}
+
 TEST_CASE("Integer conversion") {
     uint64_t i;
     i = 1;
@@ -67,3 +87,131 @@ TEST_CASE("Topological sorting string") {
     CHECK(LCompilers::ASRUtils::order_deps(deps) == std::vector<std::string>(
                 {"module_b", "module_a", "module_d", "module_c"}));
 }
+
+TEST_CASE("ASR cache entries") {
+    using LCompilers::LPython::ASRCacheEntry;
+    using LCompilers::LPython::ASRCacheModule;
+    using LCompilers::LPython::fnv1a_hash;
+    std::filesystem::path tmp = make_temp_dir("lpython_asr_cache_test");
+    LCompilers::LPython::set_asr_cache_dir((tmp / "cache").string());
+
+    std::string dep_path = (tmp / "dep.py").string();
+    {
+        std::ofstream out(dep_path);
+        out << "a: i32 = 1\n";
+    }
+    ASRCacheModule dep = {"dep", "dep", dep_path, false,
+        fnv1a_hash("a: i32 = 1\n")};
+
+    uint64_t key = LCompilers::LPython::get_asr_cache_key("mod", "mod.py",
+        "from dep import a\n", false);
+    CHECK(key != LCompilers::LPython::get_asr_cache_key("mod", "mod.py",
+        "from dep import a\n", true));
+    CHECK(key != LCompilers::LPython::get_asr_cache_key("mod", "mod.py",
+        "from dep import a\n\n", false));
+
+    std::string source = "from dep import a\n";
+    ASRCacheEntry entry;
+    entry.dependencies.push_back(dep);
+    entry.source = source;
+    entry.asr = std::string("binary\0payload\nend\n", 19);
+    LCompilers::LPython::save_asr_cache_entry("mod", "mod.py", key, entry);
+
+    ASRCacheEntry loaded;
+    CHECK(LCompilers::LPython::load_asr_cache_entry("mod", "mod.py", key,
+        source, loaded));
+    CHECK(loaded.asr == entry.asr);
+    CHECK(loaded.dependencies.size() == 1);
+    CHECK(loaded.dependencies[0].name == "dep");
+    CHECK(loaded.dependencies[0].path == dep_path);
+    CHECK(!LCompilers::LPython::load_asr_cache_entry("mod", "mod.py", key + 1,
+        source, loaded));
+    // A different source with the same key (a hash collision) is not used
+    CHECK(!LCompilers::LPython::load_asr_cache_entry("mod", "mod.py", key,
+        "from dep import b\n", loaded));
+    CHECK(!LCompilers::LPython::load_asr_cache_entry("mod", "mod.py", key,
+        source + "\n", loaded));
+
+    // The entry is stale once a dependency changed
+    entry.dependencies[0].hash = fnv1a_hash("a: i32 = 2\n");
+    LCompilers::LPython::save_asr_cache_entry("mod", "mod.py", key, entry);
+    CHECK(!LCompilers::LPython::load_asr_cache_entry("mod", "mod.py", key,
+        source, loaded));
+
+    LCompilers::LPython::set_asr_cache_dir("");
+    std::filesystem::remove_all(tmp);
+}
+
+TEST_CASE("AST serialization and cache") {
+    using LCompilers::LPython::AST::ast_t;
+    using LCompilers::LPython::AST::Module_t;
+    using LCompilers::LPython::pickle_python;
+    Allocator al(4*1024);
+    std::string source = R"(from lpython import i32, f64
+
+@decorator(1, x=2)
+def f(x: i32, *args, y: f64 = 1.5, **kwargs) -> i32:
+    """Docstring"""
+    s: str = 'a\tb' + "c"
+    for i in range(10):
+        if i % 2 == 0 and not x:
+            continue
+    z: c64 = 1 + 2j
+    return [a for a in args if a is not None][0]
+
+class A:
+    x: bool = True
+)";
+    LCompilers::diag::Diagnostics diagnostics;
+    auto r = LCompilers::LPython::parse(al, source, 0, diagnostics);
+    REQUIRE(r.ok);
+    ast_t &ast = *(ast_t*)r.result;
+
+    std::string s = LCompilers::LPython::serialize_ast(ast);
+    ast_t *ast2 = LCompilers::LPython::deserialize_ast(al, s);
+    CHECK(pickle_python(*ast2) == pickle_python(ast));
+    CHECK(LCompilers::LPython::serialize_ast(*ast2) == s);
+    ast_t *ast3 = LCompilers::LPython::deserialize_ast(al, s, 100);
+    Module_t *m = (Module_t*)r.result, *m3 = (Module_t*)ast3;
+    REQUIRE(m3->n_body == m->n_body);
+    CHECK(m3->m_body[1]->base.loc.first == m->m_body[1]->base.loc.first + 100);
+
+    // An entry is found by the contents, with the locations shifted to the
+    // new `prev_loc`
+    std::filesystem::path tmp = make_temp_dir("lpython_ast_cache_test");
+    LCompilers::LPython::set_ast_cache_dir(tmp.string());
+    LCompilers::LPython::save_ast_cache_entry(source.data(), source.size(),
+        50, *ast3);
+    ast_t *cached = LCompilers::LPython::load_ast_cache_entry(al,
+        source.data(), source.size(), 0);
+    REQUIRE(cached != nullptr);
+    CHECK(pickle_python(*cached) == pickle_python(ast));
+    CHECK(((Module_t*)cached)->m_body[1]->base.loc.first
+        == m->m_body[1]->base.loc.first + 50);
+    std::string changed = source + "\n";
+    CHECK(LCompilers::LPython::load_ast_cache_entry(al, changed.data(),
+        changed.size(), 0) == nullptr);
+
+    // An entry found by the hash of other contents of the same size (as if
+    // the hashes collided) is not used
+    std::string other = source;
+    other[other.size() - 2] = 'X';
+    auto entry = [&](const std::string &s) {
+        return tmp / (LCompilers::LPython::hash_to_hex(
+            LCompilers::LPython::fnv1a_hash(s.data(), s.size())) + ".lpyast");
+    };
+    std::filesystem::copy_file(entry(source), entry(other));
+    CHECK(LCompilers::LPython::load_ast_cache_entry(al, other.data(),
+        other.size(), 0) == nullptr);
+
+    // Large integers are not cached
+    std::string large = "x: i64 = 123456789012345678901234567890\n";
+    auto r2 = LCompilers::LPython::parse(al, large, 0, diagnostics);
+    REQUIRE(r2.ok);
+    LCompilers::LPython::save_ast_cache_entry(large.data(), large.size(), 0,
+        *(ast_t*)r2.result);
+    CHECK(LCompilers::LPython::load_ast_cache_entry(al, large.data(),
+        large.size(), 0) == nullptr);
+    LCompilers::LPython::set_ast_cache_dir("");
+    std::filesystem::remove_all(tmp);
+}
@@ -0,0 +1,179 @@
+#include <sstream>
+
+#ifndef _WIN32
+    #include <sys/resource.h>
+#endif
+#ifdef __GLIBC__
+    #include <malloc.h>
+#endif
+
+#include <libasr/string_utils.h>
+#include <lpython/time_report.h>
+#include <lpython/utils.h>
+
+namespace LCompilers::LPython {
+
+class ASRNodeCounter : public ASR::BaseWalkVisitor<ASRNodeCounter>
+{
+public:
+    ASRNodeCount count;
+
+    void visit_symbol(const ASR::symbol_t &x) {
+        count.symbols++;
+        ASR::BaseWalkVisitor<ASRNodeCounter>::visit_symbol(x);
+    }
+
+    void visit_stmt(const ASR::stmt_t &x) {
+        count.stmts++;
+        ASR::BaseWalkVisitor<ASRNodeCounter>::visit_stmt(x);
+    }
+
+    void visit_expr(const ASR::expr_t &x) {
+        count.exprs++;
+        ASR::BaseWalkVisitor<ASRNodeCounter>::visit_expr(x);
+    }
+};
+
+ASRNodeCount count_asr_nodes(ASR::TranslationUnit_t &asr) {
+    ASRNodeCounter v;
+    v.visit_TranslationUnit(asr);
+    return v.count;
+}
+
+namespace {
+
+    std::string json_node_count(const ASRNodeCount &c) {
+        return "{\"symbols\": " + std::to_string(c.symbols)
+            + ", \"stmts\": " + std::to_string(c.stmts)
+            + ", \"exprs\": " + std::to_string(c.exprs) + "}";
+    }
+
+} // namespace
+
+std::string time_report_to_text(const CompilationReport &report) {
+    std::stringstream out;
+    for (auto &stage: report.times) {
+        out << stage.first << ": " << stage.second << "ms" << std::endl;
+    }
+    for (auto &nodes: report.asr_nodes) {
+        out << "ASR nodes " << nodes.first << ": " << nodes.second.total()
+            << " (" << nodes.second.symbols << " symbols, "
+            << nodes.second.stmts << " statements, " << nodes.second.exprs
+            << " expressions)" << std::endl;
+    }
+    // Only the current chunk of the arena can be inspected, the bytes
+    // allocated in the previous ones are estimated (see MemoryUsage)
+    for (auto &m: report.memory) {
+        out << "Arena after " << m.stage << ": ~" << m.arena_allocated
+            << " bytes allocated (" << m.arena_chunks << " chunks, current chunk "
+            << m.arena_chunk_used << " of " << m.arena_chunk_size
+            << " bytes used)" << std::endl;
+    }
+    return out.str();
+}
+
+std::string time_report_to_json(const CompilationReport &report) {
+    std::stringstream out;
+    out << "{\"file\": " << json_string(report.filename) << ", \"stages\": [";
+    for (size_t i = 0; i < report.times.size(); i++) {
+        if (i > 0) out << ", ";
+        out << "{\"name\": " << json_string(report.times[i].first)
+            << ", \"time_ms\": " << report.times[i].second << "}";
+    }
+    out << "], \"asr_nodes\": [";
+    for (size_t i = 0; i < report.asr_nodes.size(); i++) {
+        if (i > 0) out << ", ";
+        out << "{\"stage\": " << json_string(report.asr_nodes[i].first)
+            << ", \"nodes\": " << json_node_count(report.asr_nodes[i].second)
+            << "}";
+    }
+    out << "], \"arena\": [";
+    for (size_t i = 0; i < report.memory.size(); i++) {
+        if (i > 0) out << ", ";
+        const MemoryUsage &m = report.memory[i];
+        out << "{\"stage\": " << json_string(m.stage)
+            << ", \"bytes_allocated_estimate\": " << m.arena_allocated
+            << ", \"chunks\": " << m.arena_chunks
+            << ", \"chunk_size\": " << m.arena_chunk_size
+            << ", \"chunk_used\": " << m.arena_chunk_used << "}";
+    }
+    out << "]}";
+    return out.str();
+}
+
+MemoryUsage get_memory_usage(const std::string &stage, Allocator &al) {
+    MemoryUsage m;
+    m.stage = stage;
+    m.arena_chunks = al.num_chunks();
+    m.arena_chunk_size = al.size_total();
+    m.arena_chunk_used = al.size_current();
+    m.arena_allocated = m.arena_chunk_used;
+    size_t chunk_size = m.arena_chunk_size;
+    for (size_t i = 1; i < m.arena_chunks; i++) {
+        chunk_size /= 2;
+        m.arena_allocated += chunk_size;
+    }
+    m.heap_in_use = 0;
+    m.peak_rss = 0;
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 mi = mallinfo2();
+    m.heap_in_use = mi.uordblks + mi.hblkhd;
+#elif defined(__GLIBC__)
+    // The fields are `int`, they wrap around above 2 GB
+    struct mallinfo mi = mallinfo();
+    m.heap_in_use = (unsigned int)mi.uordblks + (unsigned int)mi.hblkhd;
+#endif
+#ifndef _WIN32
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+        m.peak_rss = usage.ru_maxrss;
+#else
+        m.peak_rss = (size_t)usage.ru_maxrss * 1024;
+#endif
+    }
+#endif
+    return m;
+}
+
+std::string mem_report_to_text(const CompilationReport &report) {
+    if (report.memory.empty()) return "";
+    auto bytes = [](size_t n) {
+        return n == 0 ? std::string("n/a") : std::to_string(n) + " bytes";
+    };
+    std::stringstream out;
+    // Only the current chunk of the arena can be inspected (see MemoryUsage).
+    // The heap and the RSS are those of the whole process, i.e., with `-j`
+    // they include the other files being compiled at the same time.
+    out << "Memory of " << report.filename << " after each stage (arena"
+        << " chunks, bytes used of the current chunk; process heap in use"
+        << " (change); process peak RSS):" << std::endl;
+    for (size_t i = 0; i < report.memory.size(); i++) {
+        const MemoryUsage &m = report.memory[i];
+        out << "    " << m.stage << ": " << m.arena_chunks << " chunks, "
+            << m.arena_chunk_used << " of " << m.arena_chunk_size << " bytes; "
+            << bytes(m.heap_in_use);
+        if (i > 0 && m.heap_in_use > 0) {
+            int64_t change = (int64_t)m.heap_in_use
+                - (int64_t)report.memory[i-1].heap_in_use;
+            out << " (" << (change >= 0 ? "+" : "") << change << ")";
+        }
+        out << "; " << bytes(m.peak_rss) << std::endl;
+    }
+    // The backends (e.g., the LLVM context, module and code generation)
+    // live in the heap, the frontend mostly in the arena. LLVM does not
+    // report the memory of a context, so it is only part of this growth.
+    for (size_t i = 0; i < report.memory.size(); i++) {
+        if (report.memory[i].stage != "AST to ASR") continue;
+        const MemoryUsage &last = report.memory.back();
+        if (i + 1 < report.memory.size() && last.heap_in_use > 0) {
+            out << "Backend (process heap growth after AST to ASR, the LLVM"
+                << " context is not measured on its own): "
+                << (int64_t)last.heap_in_use - (int64_t)report.memory[i].heap_in_use
+                << " bytes" << std::endl;
+        }
+    }
+    return out.str();
+}
+
+} // namespace LCompilers::LPython
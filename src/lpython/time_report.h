@@ -0,0 +1,64 @@
+#ifndef LPYTHON_TIME_REPORT_H
+#define LPYTHON_TIME_REPORT_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <libasr/alloc.h>
+#include <libasr/asr.h>
+
+namespace LCompilers::LPython {
+
+    struct ASRNodeCount {
+        size_t symbols = 0;
+        size_t stmts = 0;
+        size_t exprs = 0;
+
+        size_t total() const {
+            return symbols + stmts + exprs;
+        }
+    };
+
+    ASRNodeCount count_asr_nodes(ASR::TranslationUnit_t &asr);
+
+    // The memory in use after a stage
+    struct MemoryUsage {
+        std::string stage;
+        // Of the arena the stage allocates in (the passes use the one of
+        // PythonCompiler). It grows by adding chunks, each at least twice
+        // as large as the previous one, only the current one can be inspected
+        size_t arena_chunks;
+        size_t arena_chunk_size;
+        size_t arena_chunk_used;
+        // Bytes allocated in the arena: the used bytes of the current chunk
+        // plus the sizes of the previous ones, taken as full and half as
+        // large as the next one. Exact up to the unused tail of each
+        // previous chunk, unless a single allocation was larger than twice
+        // the previous chunk.
+        size_t arena_allocated;
+        // Of the whole process (i.e., of all the files compiled in parallel
+        // with `-j`) in bytes, 0 if not available on this platform
+        size_t heap_in_use;
+        size_t peak_rss;
+    };
+
+    MemoryUsage get_memory_usage(const std::string &stage, Allocator &al);
+
+    // Everything reported by `--time-report` and `--mem-report`
+    struct CompilationReport {
+        std::string filename;
+        // Wall time of each stage in ms
+        std::vector<std::pair<std::string, double>> times;
+        // The size of the ASR before and after the ASR passes
+        std::vector<std::pair<std::string, ASRNodeCount>> asr_nodes;
+        std::vector<MemoryUsage> memory;
+    };
+
+    std::string time_report_to_text(const CompilationReport &report);
+    std::string time_report_to_json(const CompilationReport &report);
+    std::string mem_report_to_text(const CompilationReport &report);
+
+} // namespace LCompilers::LPython
+
+#endif // LPYTHON_TIME_REPORT_H
@@ -19,6 +19,8 @@
 #include <sys/stat.h>
 #ifndef _WIN32
     #include <unistd.h>
+#else
+    #include <direct.h>
 #endif
 
 #ifdef _WIN32
@@ -128,6 +130,60 @@ bool path_exists(std::string path) {
     }
 }
 
+bool create_directory(const std::string &path) {
+    if (is_directory(path)) return true;
+#ifdef _WIN32
+    return _mkdir(path.c_str()) == 0 || is_directory(path);
+#else
+    // Another process might have created it in the meantime
+    return mkdir(path.c_str(), 0755) == 0 || is_directory(path);
+#endif
+}
+
+bool remove_directory(const std::string &path) {
+#ifdef _WIN32
+    return _rmdir(path.c_str()) == 0;
+#else
+    return rmdir(path.c_str()) == 0;
+#endif
+}
+
+uint64_t fnv1a_hash(const std::string &s, uint64_t h) {
+    return fnv1a_hash(s.data(), s.size(), h);
+}
+
+uint64_t fnv1a_hash(const char *s, size_t n, uint64_t h) {
+    for (size_t i = 0; i < n; i++) {
+        h ^= (unsigned char)s[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+std::string hash_to_hex(uint64_t h) {
+    const char *digits = "0123456789abcdef";
+    std::string r(16, '0');
+    for (int i = 15; i >= 0; i--) {
+        r[i] = digits[h & 0xf];
+        h >>= 4;
+    }
+    return r;
+}
+
+std::string json_string(const std::string &s) {
+    std::string r = "\"";
+    for (char c: s) {
+        switch (c) {
+            case '"': r += "\\\""; break;
+            case '\\': r += "\\\\"; break;
+            case '\n': r += "\\n"; break;
+            case '\t': r += "\\t"; break;
+            default: r += c;
+        }
+    }
+    return r + "\"";
+}
+
 #ifdef HAVE_LFORTRAN_LLVM
 
 void open_cpython_library(DynamicLibrary &l) {
@@ -11,6 +11,17 @@ std::string get_runtime_library_dir();
 std::string get_runtime_library_header_dir();
 bool is_directory(std::string path);
 bool path_exists(std::string path);
+bool create_directory(const std::string &path);
+// Only removes empty directories
+bool remove_directory(const std::string &path);
+
+// 64-bit FNV-1a hash, `h` can be used to chain several strings
+uint64_t fnv1a_hash(const std::string &s, uint64_t h=14695981039346656037ULL);
+uint64_t fnv1a_hash(const char *s, size_t n, uint64_t h=14695981039346656037ULL);
+std::string hash_to_hex(uint64_t h);
+
+// `s` as a JSON string literal
+std::string json_string(const std::string &s);
 
 #ifdef HAVE_LFORTRAN_LLVM
 struct DynamicLibrary {